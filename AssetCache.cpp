@@ -0,0 +1,146 @@
+/*
+    AssetCache Class for use with BitmapSprite.
+
+    Loads each image file once and hands out sprites that share its image data, within a memory budget.
+*/
+
+#include "AssetCache.h"
+
+#include <SD.h>
+
+AssetCache::AssetCache(size_t budgetBytes) : budgetBytes(budgetBytes) {
+}
+
+BitmapSprite AssetCache::get(const char* filename, BitmapSprite::LoadMode mode) {
+    // Returns a sprite showing the image in the file, loaded into dynamically allocated memory with the given mode.
+    // A file already loaded with the same mode is not read again: the sprite shares the cached image data,
+    // like a copy of a sprite. Position, alpha and frames are the sprite's own, as usual.
+    // Returns an empty sprite (which renders nothing) if the file cannot be loaded, or if it does not fit
+    // in the budget after releasing all images that no sprite holds.
+    clock++;
+
+    Entry* entry = find(filename, mode);
+    if (entry) {
+        counters.hits++;
+        entry->lastUse = clock;
+        return entry->sprite;
+    }
+    counters.misses++;
+
+    // release memory before loading, so the new image is allocated into the freed space
+    // the file size is what the load needs at least; converting needs more, which is checked after loading
+    size_t needed = 0;
+    if (mode != BitmapSprite::LOAD_STREAM) {
+        File file = SD.open(filename);
+        if (file) needed = file.size();
+        file.close();
+    }
+    makeRoom(needed);
+
+    BitmapSprite sprite(filename, mode);
+    if (sprite.loadStatus() != BitmapSprite::LOAD_READY) {
+        counters.failures++;
+        return BitmapSprite();
+    }
+
+    size_t bytes = sprite.memoryUsed();
+    if (!makeRoom(bytes)) {
+        Serial.println("Error: Image does not fit in the asset cache budget.");
+        counters.failures++;
+        return BitmapSprite();
+    }
+
+    entries.push_back({filename, mode, sprite, bytes, clock});
+    counters.bytes += bytes;
+    counters.peakBytes = max(counters.peakBytes, counters.bytes);
+    return sprite;
+}
+
+bool AssetCache::contains(const char* filename, BitmapSprite::LoadMode mode) {
+    // Returns 1 if the file is cached with the given mode, so get() would not read the SD card.
+    return find(filename, mode) != nullptr;
+}
+
+void AssetCache::setBudget(size_t budgetBytes) {
+    // Changes the memory budget, releasing unused images until the cache fits.
+    this->budgetBytes = budgetBytes;
+    makeRoom(0);
+}
+
+size_t AssetCache::trim() {
+    // Releases all cached images that no sprite holds, e.g. before a scene change.
+    // Returns the number of bytes released.
+    size_t before = update();
+    size_t i = 0;
+    while (i < entries.size()) {
+        if (inUse(entries[i])) {
+            i++;
+            continue;
+        }
+        entries.erase(entries.begin() + i);
+        counters.evictions++;
+    }
+    return before - update();
+}
+
+void AssetCache::clear() {
+    // Forgets all cached images. Sprites that still show an image keep its memory until they are released.
+    entries.clear();
+    counters.bytes = 0;
+}
+
+const AssetCache::Stats& AssetCache::stats() {
+    // Returns the counters since the cache was created, with the current memory use.
+    update();
+    counters.assets = entries.size();
+    return counters;
+}
+
+bool AssetCache::inUse(const Entry& entry) {
+    // helper function checks whether any sprite besides the cache entry holds the image data
+    return entry.sprite.bmpfile.use_count() > 1 || entry.sprite.stream.use_count() > 1;
+}
+
+size_t AssetCache::update() {
+    // helper function marks the images held by sprites as used now, and totals the memory of all images
+    // memory can change after loading: the row cache of a streamed image is allocated on its first render
+    size_t total = 0;
+    for (Entry& entry : entries) {
+        if (inUse(entry)) entry.lastUse = clock;
+        entry.bytes = entry.sprite.memoryUsed();
+        total += entry.bytes;
+    }
+    counters.bytes = total;
+    counters.peakBytes = max(counters.peakBytes, total);
+    return total;
+}
+
+bool AssetCache::makeRoom(size_t bytes) {
+    // helper function releases the least recently used images that no sprite holds, until `bytes` more fit
+    // in the budget. Images held by sprites are kept: releasing them would not free their memory.
+    // Returns 0 if there is not enough room even so.
+    size_t total = update();
+
+    while (total + bytes > budgetBytes) {
+        Entry* oldest = nullptr;
+        for (Entry& entry : entries) {
+            if (inUse(entry)) continue;
+            if (!oldest || (int32_t)(entry.lastUse - oldest->lastUse) < 0) oldest = &entry;
+        }
+        if (!oldest) return 0;
+
+        total -= oldest->bytes;
+        entries.erase(entries.begin() + (oldest - entries.data()));
+        counters.evictions++;
+    }
+    counters.bytes = total;
+    return 1;
+}
+
+AssetCache::Entry* AssetCache::find(const char* filename, BitmapSprite::LoadMode mode) {
+    // helper function returns the cache entry of the file and mode, or nullptr
+    for (Entry& entry : entries) {
+        if (entry.mode == mode && entry.filename == filename) return &entry;
+    }
+    return nullptr;
+}
@@ -0,0 +1,58 @@
+/*
+    AssetCache Class for use with BitmapSprite.
+
+    Loads each image file once and hands out sprites that share its image data. The memory held by cached
+    images is kept within a budget, by releasing the least recently used images that no sprite holds any more.
+*/
+
+#ifndef AssetCache_h
+#define AssetCache_h
+
+#include "BitmapSprite.h"
+
+#include <string>
+#include <vector>
+
+class AssetCache {
+    public:
+        struct Stats {
+            uint32_t hits = 0; // get() calls served from memory
+            uint32_t misses = 0; // get() calls that loaded the file
+            uint32_t evictions = 0; // images released to stay within the budget
+            uint32_t failures = 0; // files that could not be loaded, or did not fit in the budget
+            size_t bytes = 0; // memory held by cached images
+            size_t peakBytes = 0;
+            uint16_t assets = 0; // cached images
+        };
+
+        AssetCache(size_t budgetBytes);
+
+        BitmapSprite get(const char* filename, BitmapSprite::LoadMode mode = BitmapSprite::LOAD_BMP);
+        bool contains(const char* filename, BitmapSprite::LoadMode mode = BitmapSprite::LOAD_BMP);
+        void setBudget(size_t budgetBytes);
+        size_t budget() { return budgetBytes; };
+        size_t trim();
+        void clear();
+        const Stats& stats();
+
+    private:
+        struct Entry {
+            std::string filename;
+            BitmapSprite::LoadMode mode;
+            BitmapSprite sprite; // holds the shared image data
+            size_t bytes;
+            uint32_t lastUse; // clock value when the image was last handed out, or seen held by a sprite
+        };
+
+        size_t budgetBytes;
+        uint32_t clock = 0;
+        std::vector<Entry> entries;
+        Stats counters;
+
+        bool inUse(const Entry& entry);
+        size_t update();
+        bool makeRoom(size_t bytes);
+        Entry* find(const char* filename, BitmapSprite::LoadMode mode);
+};
+
+#endif
@@ -0,0 +1,226 @@
+/*
+    BitmapFont Class for use with BitmapSprite.
+
+    Draws strings from a 1bpp font sheet, a whole screen row of text at a time.
+*/
+
+#include "BitmapFont.h"
+#include "BlendBatch.h"
+
+#include <string.h>
+
+struct ByteRuns { // runs of set bits in a byte, top bit first, in columns 0..8
+    uint8_t count;
+    uint8_t start[4];
+    uint8_t end[4]; // one past the last column of the run
+};
+
+static ByteRuns byteRunTable[256];
+
+static bool buildByteRuns() {
+    // helper function fills the run table for every byte value
+    for (uint value = 0; value < 256; value++) {
+        ByteRuns& runs = byteRunTable[value];
+        runs.count = 0;
+        for (uint col = 0; col < 8;) {
+            if (!(value & (0x80 >> col))) {
+                col++;
+                continue;
+            }
+            runs.start[runs.count] = col;
+            while (col < 8 && (value & (0x80 >> col))) col++;
+            runs.end[runs.count++] = col;
+        }
+    }
+    return 1;
+}
+
+static const ByteRuns* byteRuns() {
+    // helper function returns the run table, building it on first use
+    static bool built = buildByteRuns();
+    (void)built;
+    return byteRunTable;
+}
+
+BitmapFont::BitmapFont() {
+    // An empty font: load() a sheet before rendering.
+}
+
+BitmapFont::BitmapFont(const char* filename, uint8_t glyphWidth, uint8_t glyphHeight, uint8_t firstChar) {
+    load(filename, glyphWidth, glyphHeight, firstChar);
+}
+
+bool BitmapFont::load(const char* filename, uint8_t glyphWidth, uint8_t glyphHeight, uint8_t firstChar) {
+    // Reads a font sheet from the SD card. The file is only needed while loading.
+    BitmapSprite sheet(filename);
+    return load(sheet, glyphWidth, glyphHeight, firstChar);
+}
+
+bool BitmapFont::load(BitmapSprite& sheet, uint8_t glyphWidth, uint8_t glyphHeight, uint8_t firstChar) {
+    // Reads the glyphs from a sheet already loaded with LOAD_BMP, e.g. a pre-baked one or one from an AssetCache.
+    // The cells hold the characters from firstChar on. Of the two colors, the ink is the one covering fewer
+    // pixels of the glyph cells, so glyphs can be drawn either dark on light or light on dark.
+    glyphs = 0;
+    glyphRows.clear();
+
+    if (sheet.loadStatus() != BitmapSprite::LOAD_READY || !sheet.image || sheet.format != BitmapSprite::RGB1) {
+        Serial.println("Error: Font sheet must be a 1bpp BMP loaded with LOAD_BMP.");
+        return 0;
+    }
+    if (glyphWidth == 0 || glyphWidth > 32 || glyphHeight == 0 || glyphWidth > sheet.wd || glyphHeight > abs(sheet.ht)) {
+        Serial.println("Error: Invalid glyph size.");
+        return 0;
+    }
+
+    uint columns = sheet.wd / glyphWidth;
+    uint count = min(columns * (abs(sheet.ht) / glyphHeight), 256u - firstChar);
+    glyphRows.resize(count * glyphHeight);
+    uint ones = 0;
+
+    for (uint i = 0; i < count; i++) {
+        uint cellLeft = (i % columns) * glyphWidth;
+        uint cellTop = (i / columns) * glyphHeight;
+        for (uint row = 0; row < glyphHeight; row++) {
+            uint32_t bits = 0;
+            for (uint col = 0; col < glyphWidth; col++) {
+                if (sheetBit(sheet, cellLeft + col, cellTop + row)) bits |= 0x80000000u >> col;
+            }
+            ones += __builtin_popcount(bits);
+            glyphRows[i * glyphHeight + row] = bits;
+        }
+    }
+
+    if (ones * 2 > count * glyphWidth * glyphHeight) {
+        uint32_t cellBits = ~0u << (32 - glyphWidth);
+        for (uint32_t& bits : glyphRows) bits ^= cellBits;
+    }
+
+    this->glyphWidth = glyphWidth;
+    this->glyphHeight = glyphHeight;
+    this->firstChar = firstChar;
+    glyphs = count;
+    byteRuns();
+    return 1;
+}
+
+bool BitmapFont::sheetBit(BitmapSprite& sheet, uint col, uint row) {
+    // helper function reads one pixel of the sheet, with rows counted from the top as displayed
+    uint imageRow = (sheet.ht > 0) ? sheet.ht - 1 - row : row;
+    return sheet.image[imageRow * sheet.rowBytes + (col >> 3)] & (0x80 >> (col & 7));
+}
+
+int BitmapFont::textWidth(const char* text) {
+    // Returns the width of a string in pixels: every character takes one glyph cell.
+    return text ? strlen(text) * glyphWidth : 0;
+}
+
+size_t BitmapFont::memoryUsed() {
+    // Returns the bytes held by the glyphs.
+    return glyphRows.size() * sizeof(uint32_t);
+}
+
+template <typename P>
+bool BitmapFont::render(P* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha) {
+    // Draws a string in one color, blended with alpha. Returns 0 if none of it is visible.
+    BitmapSprite::Rect clip = {0, 0, BitmapSprite::matrixWidth - 1, BitmapSprite::matrixHeight - 1};
+    return render(buffer, x, y, text, color, alpha, clip);
+}
+
+template <typename P>
+bool BitmapFont::render(P* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha, const BitmapSprite::Rect& clip) {
+    // Draws the part of a string within the clip rectangle and the display. Characters without a glyph are
+    // left blank. Returns 0 if none of the string is visible.
+    if (!glyphs || !text || alpha == 0) return 0;
+
+    int length = strlen(text);
+    int left = max(max(clip.left, x), 0);
+    int right = min(min(clip.right, x + length * glyphWidth - 1), BitmapSprite::matrixWidth - 1);
+    int top = max(max(clip.top, y), 0);
+    int bottom = min(min(clip.bottom, y + glyphHeight - 1), BitmapSprite::matrixHeight - 1);
+    if (left > right || top > bottom) return 0;
+
+    // lay out the glyphs over the drawn area once, for all of its rows. The cells are equally wide, so
+    // the first and last characters to draw follow from the edges of the area.
+    visible.clear();
+    for (int i = (left - x) / glyphWidth; i <= (right - x) / glyphWidth; i++) {
+        uint glyph = (uint)(uint8_t)text[i] - firstChar;
+        if (glyph >= glyphs) continue;
+        visible.push_back({(uint16_t)(glyph * glyphHeight), x + i * glyphWidth - left});
+    }
+
+    uint width = right - left + 1;
+    uint words = (width + 31) / 32;
+    rowBits.resize(words + 1); // the last glyph may reach into the word after the area
+    uint32_t lastMask = ~0u << ((32 - (width & 31)) & 31);
+
+    P ink = DestPixel<P>::fromSRGB8(color.red, color.green, color.blue);
+    uint32_t red = decodeGamma8to16(color.red);
+    uint32_t green = decodeGamma8to16(color.green);
+    uint32_t blue = decodeGamma8to16(color.blue);
+    uint32_t factor = alpha * 257;
+    BlendBatch<P> batch;
+    const ByteRuns* table = byteRuns();
+    P* rowPtr = nullptr;
+
+    auto fill = [&](uint start, uint end) {
+        if (alpha == 255) {
+            for (P* ptr = rowPtr + start; ptr < rowPtr + end; ptr++) *ptr = ink;
+        } else {
+            for (P* ptr = rowPtr + start; ptr < rowPtr + end; ptr++) batch.add(ptr, red, green, blue, factor);
+        }
+    };
+
+    for (int screenY = top; screenY <= bottom; screenY++) {
+        // pack the glyph rows side by side, cut off at the left and right edges of the area
+        uint glyphRow = screenY - y;
+        memset(rowBits.data(), 0, rowBits.size() * sizeof(uint32_t));
+        for (const Glyph& glyph : visible) {
+            uint32_t bits = glyphRows[glyph.row + glyphRow];
+            if (!bits) continue;
+            int offset = glyph.offset;
+            if (offset < 0) {
+                bits <<= -offset;
+                offset = 0;
+            }
+            uint32_t* word = rowBits.data() + (offset >> 5);
+            uint shift = offset & 31;
+            word[0] |= bits >> shift;
+            if (shift) word[1] |= bits << (32 - shift);
+        }
+        rowBits[words - 1] &= lastMask;
+
+        // expand the row a byte at a time into runs of ink, joining runs that carry on into the next byte
+        rowPtr = buffer + screenY * BitmapSprite::matrixWidth + left;
+        uint runStart = 0;
+        uint runEnd = 0;
+        for (uint w = 0; w < words; w++) {
+            uint32_t bits = rowBits[w];
+            if (!bits) continue;
+            for (uint b = 0; b < 4; b++) {
+                const ByteRuns& runs = table[(bits >> (24 - 8 * b)) & 0xFF];
+                uint base = w * 32 + b * 8;
+                for (uint i = 0; i < runs.count; i++) {
+                    uint start = base + runs.start[i];
+                    if (start != runEnd) {
+                        fill(runStart, runEnd);
+                        runStart = start;
+                    }
+                    runEnd = base + runs.end[i];
+                }
+            }
+        }
+        fill(runStart, runEnd);
+    }
+    batch.flush();
+    return 1;
+}
+
+// render() is compiled for each drawing buffer pixel type
+template bool BitmapFont::render<rgb16>(rgb16* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha);
+template bool BitmapFont::render<rgb24>(rgb24* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha);
+template bool BitmapFont::render<rgb48>(rgb48* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha);
+template bool BitmapFont::render<linear48>(linear48* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha);
+template bool BitmapFont::render<rgb16>(rgb16* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha, const BitmapSprite::Rect& clip);
+template bool BitmapFont::render<rgb24>(rgb24* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha, const BitmapSprite::Rect& clip);
+template bool BitmapFont::render<rgb48>(rgb48* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha, const BitmapSprite::Rect& clip);
+template bool BitmapFont::render<linear48>(linear48* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha, const BitmapSprite::Rect& clip);
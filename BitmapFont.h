@@ -0,0 +1,60 @@
+/*
+    BitmapFont Class for use with BitmapSprite.
+
+    Draws text from a 1bpp BMP font sheet: a grid of equally sized glyph cells, in character order from the
+    top left, row by row. The sheet is read once, into one bit row per glyph row. A string is then drawn row
+    by row over its whole visible width in one pass: the glyph bits of the row are packed side by side, and
+    expanded 8 pixels at a time through a table of runs, so the text color is filled in runs and the
+    background is skipped a byte at a time. Glyphs outside the display or the clip rectangle cost nothing,
+    so a long ticker costs about as much as a single sprite of its visible size.
+*/
+
+#ifndef BitmapFont_h
+#define BitmapFont_h
+
+#include "BitmapSprite.h"
+
+#include <vector>
+
+class BitmapFont {
+    public:
+        BitmapFont();
+        BitmapFont(const char* filename, uint8_t glyphWidth, uint8_t glyphHeight, uint8_t firstChar = ' ');
+
+        bool load(const char* filename, uint8_t glyphWidth, uint8_t glyphHeight, uint8_t firstChar = ' ');
+        bool load(BitmapSprite& sheet, uint8_t glyphWidth, uint8_t glyphHeight, uint8_t firstChar = ' ');
+
+        // the drawing buffer holds rgb16, rgb24, rgb48 or linear48 pixels, like for BitmapSprite::render().
+        // (x, y) is the top left corner of the text.
+        template <typename P>
+        bool render(P* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha = 255);
+        template <typename P>
+        bool render(P* buffer, int x, int y, const char* text, const rgb24& color, uint8_t alpha, const BitmapSprite::Rect& clip);
+        int textWidth(const char* text);
+        uint8_t width() { return glyphWidth; };
+        uint8_t height() { return glyphHeight; };
+        uint16_t glyphCount() { return glyphs; };
+
+        size_t memoryUsed();
+
+    private:
+        struct Glyph { // a glyph of the string being drawn
+            uint16_t row; // its first row in glyphRows
+            int offset; // its first column, counted from the left edge of the drawn area
+        };
+
+        uint8_t glyphWidth = 0; // at most 32: each glyph row is one word
+        uint8_t glyphHeight = 0;
+        uint8_t firstChar = ' ';
+        uint16_t glyphs = 0;
+
+        // glyph rows from the top, one word each: a set bit is ink, leftmost pixel in the top bit
+        std::vector<uint32_t> glyphRows;
+
+        std::vector<Glyph> visible; // render(): glyphs within the drawn area
+        std::vector<uint32_t> rowBits; // render(): ink of one screen row of the drawn area
+
+        static bool sheetBit(BitmapSprite& sheet, uint col, uint row);
+};
+
+#endif
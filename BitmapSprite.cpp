@@ -2,12 +2,35 @@
     BitmapSprite Class for use with SmartMatrix Library.
 
     Sprites are 2D images with transparency that can be rendered at any position on the display.
-    Image data is loaded from BMP files on the SD Card.
+    Image data is loaded from BMP files on the SD Card, or from pre-baked images (see bake()).
 */
 
 #include "BitmapSprite.h"
 #include <SD.h>
 #include "gammaLUT.h"
+#include "BlendBatch.h"
+
+#include <type_traits>
+#if defined(BITMAPSPRITE_STATS)
+#include <chrono>
+#if defined(BITMAPSPRITE_THREADS)
+#include <mutex>
+#endif
+#endif
+
+#if defined(BITMAPSPRITE_STATS)
+// Work done by the render call in progress, counted by the kernels and merged into the totals when it returns.
+#if defined(BITMAPSPRITE_THREADS)
+static thread_local BitmapSprite::RenderCounters statsCall;
+static std::mutex statsMutex; // SpriteBatch renders bands of the same sprite on several threads
+#else
+static BitmapSprite::RenderCounters statsCall;
+#endif
+static BitmapSprite::RenderStats statsFrame;
+#define COUNT_STATS(field, n) (statsCall.field += (n))
+#else
+#define COUNT_STATS(field, n)
+#endif
 
 uint16_t BitmapSprite::matrixWidth = 0;
 uint16_t BitmapSprite::matrixHeight = 0;
@@ -21,216 +44,2239 @@ void BitmapSprite::setDisplaySize(uint16_t displayWidth, uint16_t displayHeight)
 BitmapSprite::BitmapSprite() {
 }
 
-BitmapSprite::BitmapSprite(const char* filename) {
+BitmapSprite::BitmapSprite(const char* filename, LoadMode mode) {
     // Reads the SD card and dynamically allocates new memory for image data.
-    loadBitmap(filename);
+    // With LOAD_STREAM, the row cache is allocated on the first render, sized for the display.
+    loadBitmap(filename, nullptr, 0, mode);
 }
 
-BitmapSprite::BitmapSprite(const char* filename, void* destination, size_t allocatedSize) {
+BitmapSprite::BitmapSprite(const char* filename, void* destination, size_t allocatedSize, LoadMode mode) {
     // Reads the SD card and places image data into a statically allocated memory range.
-    loadBitmap(filename, destination, allocatedSize);
+    // If the image is converted (mode other than LOAD_BMP), the range must hold the file plus the converted image.
+    // With LOAD_STREAM, the range is used as the row cache instead, which bounds the memory used by large images.
+    loadBitmap(filename, destination, allocatedSize, mode);
 }
 
-bool BitmapSprite::render(rgb24* buffer) {
+template <typename P>
+bool BitmapSprite::render(P* buffer) {
     // Renders the sprite to the provided drawing buffer.
     // Returns 0 if the sprite is invisible or not properly initialized.
+    Rect display = {0, 0, matrixWidth - 1, matrixHeight - 1};
+    return render(buffer, display);
+}
+
+template <typename P>
+bool BitmapSprite::render(P* buffer, const Rect& clip) {
+    // Renders the part of the sprite that falls within the clip rectangle (screen coordinates).
+    // Returns 0 if nothing was drawn.
     if (alpha == 0) return 0; // invisible
-    if (!image || wd == 0 || ht == 0) return 0; // not properly initialized
+    if (loading) return 0; // still loading
+    if ((!image && !stream) || wd == 0 || ht == 0) return 0; // not properly initialized
     if (matrixWidth == 0 || matrixHeight == 0) return 0; // display size not set
+    if (frames && frame >= frames->size()) return 0; // no such frame
+
+    Rect rect = bounds();
+#if defined(BITMAPSPRITE_STATS)
+    countCall(rect, clip);
+#endif
+    return renderClipped(buffer, rect, clip);
+}
+
+#if defined(BITMAPSPRITE_STATS)
+static inline uint32_t statsTicks() {
+    // helper function reads the cycle counter on the Teensy, or a nanosecond clock on the host
+#if defined(ARM_DWT_CYCCNT)
+    return ARM_DWT_CYCCNT;
+#else
+    return (uint32_t)std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+static inline uint32_t ticksPerMicro() {
+#if defined(ARM_DWT_CYCCNT)
+    return F_CPU_ACTUAL / 1000000;
+#else
+    return 1000;
+#endif
+}
+
+static inline uint32_t area(int left, int top, int right, int bottom) {
+    // helper function returns the number of pixels in a rectangle, 0 if it is empty
+    if (left > right || top > bottom) return 0;
+    return (uint32_t)(right - left + 1) * (uint32_t)(bottom - top + 1);
+}
+
+BitmapSprite::RenderCounters& BitmapSprite::RenderCounters::operator+=(const RenderCounters& other) {
+    calls += other.calls;
+    pixels += other.pixels;
+    skipped += other.skipped;
+    copied += other.copied;
+    blended += other.blended;
+    clipped += other.clipped;
+    ticks += other.ticks;
+    return *this;
+}
+
+void BitmapSprite::RenderCounters::print(const char* label) const {
+    // Prints one line of counters, with the time in microseconds.
+    Serial.printf("%-8s calls %llu  pixels %llu  skipped %llu  copied %llu  blended %llu  clipped %llu  us %llu\n", label,
+        (unsigned long long)calls, (unsigned long long)pixels, (unsigned long long)skipped, (unsigned long long)copied,
+        (unsigned long long)blended, (unsigned long long)clipped, (unsigned long long)(ticks / ticksPerMicro()));
+}
+
+BitmapSprite::RenderStats BitmapSprite::stats() {
+    // Returns the work done by all sprites since the last resetStats().
+#if defined(BITMAPSPRITE_THREADS)
+    std::lock_guard<std::mutex> lock(statsMutex);
+#endif
+    return statsFrame;
+}
+
+void BitmapSprite::resetStats() {
+    // Clears the totals, e.g. at the start of each frame. The counters of each sprite are kept.
+#if defined(BITMAPSPRITE_THREADS)
+    std::lock_guard<std::mutex> lock(statsMutex);
+#endif
+    statsFrame = RenderStats();
+}
+
+void BitmapSprite::printStats() {
+    // Prints the totals since the last resetStats(), and a line for each image format that was rendered.
+    RenderStats s = stats();
+    s.total.print("total");
+    for (uint8_t f = 0; f < FORMAT_COUNT; f++) {
+        if (s.formats[f].calls > 0 || s.formats[f].pixels > 0) s.formats[f].print(formatName(f));
+    }
+}
+
+const char* BitmapSprite::formatName(uint8_t format) {
+    static const char* const names[FORMAT_COUNT] = {"RGB1", "RGB4", "RGB8", "XRGB16", "RGB24", "ARGB32", "XRGB32", "RGB24A", "LINEAR64", "RLE8", "RLE4"};
+    return (format < FORMAT_COUNT) ? names[format] : "?";
+}
+
+void BitmapSprite::countCall(const Rect& rect, const Rect& clip) {
+    // helper function counts one render of the sprite placed at rect, and the pixels cut off by the clip
+    // rectangle and the display edges
+    RenderCounters call;
+    call.calls = 1;
+    uint32_t visible = area(max(max(rect.left, clip.left), 0), max(max(rect.top, clip.top), 0),
+        min(min(rect.right, clip.right), matrixWidth - 1), min(min(rect.bottom, clip.bottom), matrixHeight - 1));
+    call.clipped = area(rect.left, rect.top, rect.right, rect.bottom) - visible;
+    addStats(call);
+}
+
+void BitmapSprite::addStats(const RenderCounters& call) {
+    // helper function adds the work of one call to the counters of the sprite, the totals and its format
+#if defined(BITMAPSPRITE_THREADS)
+    std::lock_guard<std::mutex> lock(statsMutex);
+#endif
+    counters += call;
+    statsFrame.total += call;
+    if (format < FORMAT_COUNT) statsFrame.formats[format] += call;
+}
+#endif
+
+BitmapSprite::Rect BitmapSprite::bounds() {
+    // Returns the screen rectangle covered by the sprite (the current frame, if frames are set).
+    // It may extend past the edges of the display.
+    if (transformed) return transformedBounds();
 
-    int topval, bottomval, leftval, rightval;
+    Rect rect;
+    int w = width();
+    int h = height();
 
     if (ht > 0) { // bitmap is stored bottom-to-top
         // place sprite so that bottom left corner is at (x,y) on screen)
-        topval = y - abs(ht) + 1;
-        bottomval = y;
-        leftval = x;
-        rightval = x + wd - 1;
+        rect.top = y - h + 1;
+        rect.bottom = y;
+        rect.left = x;
+        rect.right = x + w - 1;
     } else { // bitmap is stored top-to-bottom
         // place sprite so that top left corner is at (x,y) on screen)
-        topval = y;
-        bottomval = y + abs(ht) - 1;
-        leftval = x;
-        rightval = x + wd - 1;
+        rect.top = y;
+        rect.bottom = y + h - 1;
+        rect.left = x;
+        rect.right = x + w - 1;
+    }
+    return rect;
+}
+
+uint16_t BitmapSprite::width() {
+    // Returns the width of the sprite, or of the current frame if frames are set.
+    Rect src = source();
+    return src.right - src.left + 1;
+}
+
+uint16_t BitmapSprite::height() {
+    // Returns the height of the sprite, or of the current frame if frames are set.
+    Rect src = source();
+    return src.bottom - src.top + 1;
+}
+
+size_t BitmapSprite::memoryUsed() {
+    // Returns the bytes of dynamically allocated memory held by the image: file or converted data,
+    // span and row indexes, coverage mask, row cache, decoded palette, color transform and atlas frames. Copies of the
+    // sprite share this memory, except for the colors of a sprite recolored with setPalette(), which are included too.
+    // Statically allocated memory passed to the constructor or beginLoad() is not included.
+    uint rows = abs(ht);
+    size_t bytes = 0;
+    if (bmpfile) {
+        if (stream) {
+            bytes += max((size_t)stream->dataOffset, (size_t)(14 + 124)); // header and palette only
+        } else if (format == RGB24A || format == LINEAR64) {
+            bytes += rowBytes * rows;
+        } else {
+            bytes += fsize;
+        }
+    }
+    if (stream && stream->memory) bytes += stream->size;
+    if (baked) {
+        // the indexes are part of the pre-baked data
+    } else {
+        if (spanIndex) bytes += (rows + 1) * sizeof(uint32_t) + (spanIndex.get()[rows] + 1) / 2 * sizeof(uint32_t);
+        if (rleIndex) bytes += 2 * rows * sizeof(uint32_t);
+    }
+    if (coverMask) bytes += maskWords * rows * sizeof(uint32_t);
+    if (imageColors) bytes += paletteEntries() * sizeof(PaletteColor);
+    if (paletteColors && paletteColors != imageColors) bytes += paletteEntries() * sizeof(PaletteColor);
+    if (mappedColors) bytes += paletteEntries() * sizeof(PaletteColor);
+    if (colorMap) bytes += sizeof(ColorMap);
+    if (frames) bytes += frames->size() * sizeof(Rect);
+    return bytes;
+}
+
+bool BitmapSprite::setFrameGrid(uint16_t frameWidth, uint16_t frameHeight, uint16_t count) {
+    // Divides the image into a grid of frames, numbered left to right, then top to bottom as displayed.
+    // count limits the number of frames, for a partly filled last row; 0 uses all whole cells.
+    // Frames are shared by copies of the sprite; select one with the frame member.
+    if (frameWidth == 0 || frameHeight == 0 || frameWidth > wd || frameHeight > abs(ht)) {
+        Serial.println("Error: Frame size does not fit the image.");
+        return 0;
+    }
+
+    uint columns = wd / frameWidth;
+    uint cells = columns * (abs(ht) / frameHeight);
+    if (count == 0 || count > cells) count = cells;
+
+    std::vector<Rect> rects(count);
+    for (uint i = 0; i < count; i++) {
+        rects[i].left = (i % columns) * frameWidth;
+        rects[i].top = (i / columns) * frameHeight;
+        rects[i].right = rects[i].left + frameWidth - 1;
+        rects[i].bottom = rects[i].top + frameHeight - 1;
+    }
+    return setFrames(rects.data(), count);
+}
+
+bool BitmapSprite::setFrames(const Rect* rects, uint16_t count) {
+    // Sets the frames of an atlas: rectangles in image pixels, counted from the top left as displayed,
+    // edges inclusive. A count of 0 removes the frames, so the whole image is rendered again.
+    if (count == 0) {
+        frames.reset();
+        return 1;
+    }
+
+    for (uint i = 0; i < count; i++) {
+        const Rect& r = rects[i];
+        if (r.left < 0 || r.top < 0 || r.right >= wd || r.bottom >= abs(ht) || r.left > r.right || r.top > r.bottom) {
+            Serial.println("Error: Frame outside of the image.");
+            return 0;
+        }
+    }
+
+    frames = std::make_shared<std::vector<Rect>>(rects, rects + count);
+    return 1;
+}
+
+bool BitmapSprite::setPalette(const rgb24* colors, uint16_t count, uint16_t first) {
+    // Recolors an indexed image (1, 4 or 8 bpp, or RLE; not converted by the load mode): replaces the palette
+    // entries [first, first + count) of this sprite, and of copies made from it afterwards. The image data stays
+    // shared with all other copies. Only the new colors are decoded, so palette cycling every frame is cheap.
+    if (!paletteColors) {
+        Serial.println("Error: Only indexed images can be recolored.");
+        return 0;
+    }
+    uint entries = paletteEntries();
+    if ((uint)first + count > entries) {
+        Serial.println("Error: Palette index out of range.");
+        return 0;
+    }
+
+    if (paletteColors == imageColors || paletteColors.use_count() > 1) {
+        // the colors in use are shared with the image or with other sprites: recolor a copy
+        PaletteColor* copy = new PaletteColor[entries];
+        if (!copy) {
+            Serial.println("Error: Failed to allocate memory.");
+            return 0;
+        }
+        memcpy(copy, paletteColors.get(), entries * sizeof(PaletteColor));
+        paletteColors.reset(copy, std::default_delete<PaletteColor[]>());
+    }
+
+    for (uint i = 0; i < count; i++) {
+        decodeColor(paletteColors.get()[first + i], colors[i].red, colors[i].green, colors[i].blue);
+    }
+    colorChanges++;
+    if (colorMap) return mapPalette(first, count);
+    return 1;
+}
+
+void BitmapSprite::resetPalette() {
+    // Restores the image's own colors after setPalette().
+    if (paletteColors == imageColors) return;
+    paletteColors = imageColors;
+    colorChanges++;
+    if (colorMap) mapPalette(0, paletteEntries());
+}
+
+static inline uint32_t clamp8(int32_t c) {
+    // helper function clamps a mapped channel value to 0..255
+    return (c < 0) ? 0 : (c > 255) ? 255 : c;
+}
+
+BitmapSprite::ColorTransform BitmapSprite::ColorTransform::tint(uint8_t red, uint8_t green, uint8_t blue) {
+    // Returns a transform multiplying each channel by the color, as in a multiply blend: white keeps the sprite as it is.
+    ColorTransform t;
+    t.matrix[0][0] = (red * 256 + 127) / 255;
+    t.matrix[1][1] = (green * 256 + 127) / 255;
+    t.matrix[2][2] = (blue * 256 + 127) / 255;
+    return t;
+}
+
+BitmapSprite::ColorTransform BitmapSprite::ColorTransform::brightness(int16_t scale, int16_t add) {
+    // Returns a transform scaling all channels by scale / 256 (8.8 fixed point), then adding add to them.
+    ColorTransform t;
+    for (int i = 0; i < 3; i++) {
+        t.matrix[i][i] = scale;
+        t.offset[i] = add;
+    }
+    return t;
+}
+
+BitmapSprite::ColorTransform BitmapSprite::ColorTransform::saturation(int16_t amount) {
+    // Returns a transform mixing each channel with the luma of the pixel (Rec. 601 weights): amount is 8.8 fixed
+    // point, 0 gives grey, 256 keeps the colors and larger values push them further away from grey.
+    static const int16_t luma[3] = {77, 150, 29};
+    ColorTransform t;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            t.matrix[i][j] = ((256 - amount) * luma[j]) / 256 + ((i == j) ? amount : 0);
+        }
+    }
+    return t;
+}
+
+BitmapSprite::ColorTransform BitmapSprite::ColorTransform::then(const ColorTransform& next) const {
+    // Returns the transform applying this one, then next, e.g. tint(...).then(brightness(320)).
+    // The result is clamped once, at the end.
+    ColorTransform t;
+    for (int i = 0; i < 3; i++) {
+        int32_t add = next.offset[i] * 256;
+        for (int j = 0; j < 3; j++) {
+            int32_t sum = 0;
+            for (int k = 0; k < 3; k++) sum += next.matrix[i][k] * matrix[k][j];
+            t.matrix[i][j] = (sum + 128) >> 8;
+            add += next.matrix[i][j] * offset[j];
+        }
+        t.offset[i] = (add + 128) >> 8;
+    }
+    return t;
+}
+
+bool BitmapSprite::setColorTransform(const ColorTransform& transform) {
+    // Tints, brightens or otherwise recolors the sprite, and copies made from it afterwards, by passing every pixel
+    // through a color matrix before it is blended. The image data stays shared. Indexed images have their palette
+    // mapped once here, so they render as fast as without a transform; other formats map each pixel in the kernel.
+    // The transform is kept when the sprite loads another image.
+    ColorMap* map = new ColorMap();
+    if (!map) {
+        Serial.println("Error: Failed to allocate memory.");
+        return 0;
+    }
+
+    map->transform = transform;
+    map->diagonal = true;
+    for (int i = 0; i < 3; i++) {
+        for (int j = 0; j < 3; j++) {
+            if (i != j && transform.matrix[i][j] != 0) map->diagonal = false;
+        }
+    }
+    for (int i = 0; i < 3; i++) {
+        for (int v = 0; v < 256; v++) {
+            int32_t c = ((transform.matrix[i][i] * v + 128) >> 8) + transform.offset[i];
+            map->table[i][v] = clamp8(c);
+        }
+    }
+    colorMap.reset(map);
+    colorChanges++;
+    if (paletteColors) return mapPalette(0, paletteEntries());
+    return 1;
+}
+
+void BitmapSprite::resetColorTransform() {
+    // Draws the sprite in its own colors again after setColorTransform().
+    if (!colorMap) return;
+    colorMap.reset();
+    mappedColors.reset();
+    colorChanges++;
+}
+
+bool BitmapSprite::mapPalette(uint first, uint count) {
+    // helper function passes the palette entries [first, first + count) through the color transform, into the
+    // colors the kernels draw with. The table is copied first, as a whole, if copies of the sprite share it.
+    uint entries = paletteEntries();
+    if (!mappedColors || mappedColors.use_count() > 1) {
+        PaletteColor* colors = new PaletteColor[entries];
+        if (!colors) {
+            Serial.println("Error: Failed to allocate memory.");
+            mappedColors.reset(); // draw the sprite's own colors rather than stale ones
+            return 0;
+        }
+        mappedColors.reset(colors, std::default_delete<PaletteColor[]>());
+        first = 0;
+        count = entries;
     }
 
-    int startY = max(topval, 0);
-    int endY = min(bottomval, matrixHeight - 1);
-    int startX = max(leftval, 0);
-    int endX = min(rightval, matrixWidth - 1);
+    for (uint i = first; i < first + count; i++) {
+        const PaletteColor& c = paletteColors.get()[i];
+        uint32_t r = c.red;
+        uint32_t g = c.green;
+        uint32_t b = c.blue;
+        mapColor(*colorMap, r, g, b);
+        decodeColor(mappedColors.get()[i], r, g, b);
+    }
+    return 1;
+}
+
+void BitmapSprite::mapColor(const ColorMap& map, uint32_t& r, uint32_t& g, uint32_t& b) {
+    // helper function passes an 8-bit sRGB color through a color transform
+    if (map.diagonal) {
+        r = map.table[0][r];
+        g = map.table[1][g];
+        b = map.table[2][b];
+        return;
+    }
+
+    const ColorTransform& t = map.transform;
+    int32_t sr = r, sg = g, sb = b;
+    r = clamp8(((t.matrix[0][0] * sr + t.matrix[0][1] * sg + t.matrix[0][2] * sb + 128) >> 8) + t.offset[0]);
+    g = clamp8(((t.matrix[1][0] * sr + t.matrix[1][1] * sg + t.matrix[1][2] * sb + 128) >> 8) + t.offset[1]);
+    b = clamp8(((t.matrix[2][0] * sr + t.matrix[2][1] * sg + t.matrix[2][2] * sb + 128) >> 8) + t.offset[2]);
+}
+
+template <BitmapSprite::Format F>
+void BitmapSprite::mapPixel(const ColorMap& map, uint32_t& r, uint32_t& g, uint32_t& b) {
+    // helper function passes a pixel read by readPixel through a color transform.
+    // LINEAR64 pixels are mapped as 8-bit sRGB too, so every load mode draws the same colors.
+    if (F == LINEAR64) {
+        r = encodeGamma16to8(r);
+        g = encodeGamma16to8(g);
+        b = encodeGamma16to8(b);
+    }
+    mapColor(map, r, g, b);
+    if (F == LINEAR64) {
+        r = decodeGamma8to16(r);
+        g = decodeGamma8to16(g);
+        b = decodeGamma8to16(b);
+    }
+}
+
+uint BitmapSprite::paletteEntries() {
+    // helper function returns the number of possible palette indexes of an indexed image
+    if (format == RGB1) return 2;
+    if (format == RGB4 || format == RLE4) return 16;
+    return 256;
+}
+
+bool BitmapSprite::decodePalette(uint count) {
+    // helper function decodes the first `count` BGRX colors of the image palette, once per load, so rendering
+    // needs no gamma table lookups for them. Indexes past them, which valid images do not use, are black.
+    uint entries = paletteEntries();
+    PaletteColor* colors = new PaletteColor[entries]();
+    if (!colors) {
+        Serial.println("Error: Failed to allocate memory.");
+        return 0;
+    }
+
+    for (uint i = 0; i < min(count, entries); i++) {
+        decodeColor(colors[i], palette[i * 4 + 2], palette[i * 4 + 1], palette[i * 4]);
+    }
+    imageColors.reset(colors, std::default_delete<PaletteColor[]>());
+    paletteColors = imageColors;
+    mappedColors.reset();
+    if (colorMap) mapPalette(0, entries);
+    return 1;
+}
+
+void BitmapSprite::decodeColor(PaletteColor& color, uint8_t r, uint8_t g, uint8_t b) {
+    // helper function sets a palette entry from an sRGB color
+    color.red = r;
+    color.green = g;
+    color.blue = b;
+    color.linearRed = decodeGamma8to16(r);
+    color.linearGreen = decodeGamma8to16(g);
+    color.linearBlue = decodeGamma8to16(b);
+}
+
+bool BitmapSprite::hitTest(int screenX, int screenY) {
+    // Returns 1 if the sprite covers the screen pixel: the pixel lies on the sprite, where it is not fully
+    // transparent. The sprite is placed as by render(), with its current frame and transform; its alpha is
+    // ignored, so faded and hidden sprites can still be hit. Streamed images count as covering their rectangle.
+    Placement placement;
+    if (!place(placement)) return 0;
+    return covers(placement, screenX, screenY);
+}
+
+bool BitmapSprite::collidesWith(BitmapSprite& other) {
+    // Returns 1 if the two sprites cover a common screen pixel, placed and tested as by hitTest().
+    // Rectangles are compared first, then the coverage masks of the overlapping rows, 32 pixels at a time.
+    // Transformed sprites are sampled at each pixel of the overlap instead.
+    Placement a, b;
+    if (!place(a) || !other.place(b)) return 0;
+
+    int left = max(a.rect.left, b.rect.left);
+    int right = min(a.rect.right, b.rect.right);
+    int top = max(a.rect.top, b.rect.top);
+    int bottom = min(a.rect.bottom, b.rect.bottom);
+    if (left > right || top > bottom) return 0;
+
+    if (transformed || other.transformed) {
+        for (int y = top; y <= bottom; y++) {
+            for (int x = left; x <= right; x++) {
+                if (covers(a, x, y) && other.covers(b, x, y)) return 1;
+            }
+        }
+        return 0;
+    }
+
+    if (!coverMask && !other.coverMask) return 1; // both cover their whole rectangle
+
+    uint colA = a.src.left + left - a.rect.left;
+    uint colB = b.src.left + left - b.rect.left;
+    uint count = right - left + 1;
+
+    for (int y = top; y <= bottom; y++) {
+        uint rowA = imageRow(a, y);
+        uint rowB = other.imageRow(b, y);
+        for (uint i = 0; i < count; i += 32) {
+            uint32_t bits = maskBits(rowA, colA + i) & other.maskBits(rowB, colB + i);
+            if (count - i < 32) bits &= ~0u << (32 - (count - i)); // past the overlap
+            if (bits) return 1;
+        }
+    }
+    return 0;
+}
+
+bool BitmapSprite::occludes() {
+    // helper function returns whether the sprite hides everything behind its rectangle, for front-to-back
+    // rendering (see SpriteBatch::setOcclusion): every pixel is drawn opaque
+    if (transformed || (!image && !stream)) return 0;
+    if (blend == BLEND_REPLACE) return alpha == 255 && (!alphaChannel || (format != RLE8 && format != RLE4)); // only RLE gaps show through
+    if (blend != BLEND_OVER || alpha != 255) return 0;
+    return !alphaChannel;
+}
+
+bool BitmapSprite::place(Placement& placement) {
+    // helper function finds where the sprite is on the screen, for coverage queries.
+    // Returns 0 if it has no image to test, like render().
+    if (loading) return 0;
+    if ((!image && !stream) || wd == 0 || ht == 0) return 0;
+    if (frames && frame >= frames->size()) return 0;
+    if (transformed && (stream || format == RLE8 || format == RLE4)) return 0; // not drawn by renderAffine()
+    if (maskPending) {
+        maskPending = false;
+        buildMask();
+    }
+
+    placement.rect = bounds();
+    placement.src = source();
+    if (transformed && !affineMap(placement.map)) return 0;
+    return placement.rect.left <= placement.rect.right && placement.rect.top <= placement.rect.bottom;
+}
+
+bool BitmapSprite::covers(const Placement& placement, int screenX, int screenY) {
+    // helper function tests one screen pixel against the placed sprite
+    const Rect& rect = placement.rect;
+    if (screenX < rect.left || screenX > rect.right || screenY < rect.top || screenY > rect.bottom) return 0;
+    if (!transformed) return maskBit(imageRow(placement, screenY), placement.src.left + screenX - rect.left);
+
+    // the image pixel under the pixel center, as sampled by renderAffine() without bilinear filtering
+    const AffineMap& map = placement.map;
+    int64_t dx = ((int64_t)screenX << 16) + 0x8000 - transform.x;
+    int64_t dy = ((int64_t)screenY << 16) + 0x8000 - transform.y;
+    int64_t u = ((map.a * dx + map.b * dy) >> 16) + ((int64_t)map.width << 15);
+    int64_t v = ((map.c * dx + map.d * dy) >> 16) + ((int64_t)map.height << 15);
+    if (u < 0 || v < 0 || u >= ((int64_t)map.width << 16) || v >= ((int64_t)map.height << 16)) return 0;
+    return maskBit(map.rowBase + map.rowStep * (int)(v >> 16), map.colBase + (int)(u >> 16));
+}
+
+uint BitmapSprite::imageRow(const Placement& placement, int screenY) {
+    // helper function returns the image row shown on a screen row of the untransformed sprite:
+    // rows are counted from the bottom for bottom-to-top bitmaps, as in renderVisible()
+    int frameRow = placement.src.top + screenY - placement.rect.top;
+    return (ht > 0) ? abs(ht) - 1 - frameRow : frameRow;
+}
+
+bool BitmapSprite::maskBit(uint row, uint col) {
+    // helper function returns the coverage of one image pixel
+    if (!coverMask) return 1;
+    return (coverMask.get()[row * maskWords + (col >> 5)] >> (31 - (col & 31))) & 1;
+}
+
+uint32_t BitmapSprite::maskBits(uint row, uint col) {
+    // helper function returns the coverage of 32 image pixels from col, leftmost in the top bit.
+    // Pixels past the end of the row are not covered.
+    if (!coverMask) return 0xFFFFFFFF;
+    const uint32_t* rowMask = coverMask.get() + row * maskWords;
+    uint word = col >> 5;
+    uint shift = col & 31;
+    uint32_t bits = rowMask[word] << shift;
+    if (shift && word + 1 < maskWords) bits |= rowMask[word + 1] >> (32 - shift);
+    return bits;
+}
+
+template <typename P>
+P BitmapSprite::opaqueColor(const PaletteColor& color) {
+    // helper function returns a palette color as a drawing buffer pixel: linear48 takes the decoded color
+    if (std::is_same<P, linear48>::value) return DestPixel<P>::fromLinear16(color.linearRed, color.linearGreen, color.linearBlue);
+    return DestPixel<P>::fromSRGB8(color.red, color.green, color.blue);
+}
+
+BitmapSprite::Rect BitmapSprite::source() {
+    // helper function returns the image rectangle to render: the current frame, or the whole image
+    if (!frames) return {0, 0, wd - 1, abs(ht) - 1};
+    if (frame >= frames->size()) return {0, 0, -1, -1};
+    return (*frames)[frame];
+}
+
+template <typename P>
+bool BitmapSprite::renderClipped(P* buffer, const Rect& rect, const Rect& clip) {
+    // helper function renders the sprite, placed at rect, within the clip rectangle and the display
+#if defined(BITMAPSPRITE_STATS)
+    statsCall = RenderCounters();
+    uint32_t start = statsTicks();
+    bool drawn = renderVisible(buffer, rect, clip);
+    statsCall.ticks = statsTicks() - start;
+    statsCall.skipped = statsCall.pixels - statsCall.copied - statsCall.blended;
+    addStats(statsCall);
+    return drawn;
+#else
+    return renderVisible(buffer, rect, clip);
+#endif
+}
+
+template <typename P>
+bool BitmapSprite::renderVisible(P* buffer, const Rect& rect, const Rect& clip) {
+    // helper function draws the part of the sprite within the clip rectangle and the display
+    if (transformed) return renderAffine(buffer, rect, clip);
+
+    int startY = max(max(rect.top, clip.top), 0);
+    int endY = min(min(rect.bottom, clip.bottom), matrixHeight - 1);
+    int startX = max(max(rect.left, clip.left), 0);
+    int endX = min(min(rect.right, clip.right), matrixWidth - 1);
 
     if (startX > endX) return 0;
     if (startY > endY) return 0;
+    if (alpha != 255 && FadePixel<P>::SUPPORTED) prepareFade(rect);
+
+    // image row of screen row y: rows are counted from the bottom for bottom-to-top bitmaps
+    Rect src = source();
+    int rowStep = (ht > 0) ? -1 : 1;
+    int rowOrigin = (ht > 0) ? abs(ht) - 1 - src.top + rect.top : src.top - rect.top;
+    P* bufRowPtr = buffer + startX + startY * matrixWidth;
+    uint col = src.left + startX - rect.left;
+    uint count = endX - startX + 1;
+    COUNT_STATS(pixels, count * (endY - startY + 1));
+
+    if (stream) {
+        // rows come from the SD card: cache the visible ones, with read-ahead, then composite from the cache
+        uint firstRow = min(rowOrigin + rowStep * startY, rowOrigin + rowStep * endY);
+        uint lastRow = max(rowOrigin + rowStep * startY, rowOrigin + rowStep * endY);
+        if (!prepareStream(firstRow, lastRow, col, count)) return 0;
+    }
+    if (blend != BLEND_OVER) return renderBlendMode(bufRowPtr, startY, endY, rowOrigin, rowStep, col, count);
+
+    if (stream) {
+        RowKernel<P> kernel = selectKernel<P>(alphaChannel, alpha != 255);
+
+        for (int y = startY; y <= endY; y++) {
+            uint segCol;
+            const uint8_t* rowPtr = streamRow(rowOrigin + rowStep * y, col, count, segCol);
+            (this->*kernel)(bufRowPtr, rowPtr, col - segCol, count);
+            bufRowPtr += matrixWidth;
+        }
+        return 1;
+    }
+
+    if (format == RLE8 || format == RLE4) {
+        // compressed rows: walk the runs from the row index, filling and blending them directly
+        for (int y = startY; y <= endY; y++) {
+            if (format == RLE8) {
+                renderRLERow<P, RLE8>(bufRowPtr, rowOrigin + rowStep * y, col, count, alpha);
+            } else {
+                renderRLERow<P, RLE4>(bufRowPtr, rowOrigin + rowStep * y, col, count, alpha);
+            }
+            bufRowPtr += matrixWidth;
+        }
+        return 1;
+    }
+
+    if (spanIndex) {
+        // skip transparent runs, write opaque runs without blending, blend only the rest
+        RowKernel<P> copyKernel = selectKernel<P>(false, alpha != 255);
+        RowKernel<P> blendKernel = selectKernel<P>(true, alpha != 255);
+
+        for (int y = startY; y <= endY; y++) {
+            renderSpans(bufRowPtr, rowOrigin + rowStep * y, col, count, copyKernel, blendKernel);
+            bufRowPtr += matrixWidth;
+        }
+        return 1;
+    }
+
+    // pick the row kernel once; it walks each clipped row with running pointers
+    RowKernel<P> kernel = selectKernel<P>(alphaChannel, alpha != 255);
+
+    for (int y = startY; y <= endY; y++) {
+        (this->*kernel)(bufRowPtr, image + (rowOrigin + rowStep * y) * rowBytes, col, count);
+        bufRowPtr += matrixWidth;
+    }
+    return 1;
+}
+
+void BitmapSprite::prepareFade(const Rect& rect) {
+    // helper function builds the fade table for the sprite alpha (see FadeTable) if the sprite covers enough
+    // of the display to pay for it. The whole visible sprite counts, so SpriteBatch bands decide alike.
+    int w = min(rect.right, matrixWidth - 1) - max(rect.left, 0) + 1;
+    int h = min(rect.bottom, matrixHeight - 1) - max(rect.top, 0) + 1;
+    if (w > 0 && h > 0 && (uint)(w * h) >= FadeTable::MIN_PIXELS) FadeTable::prepare(alpha);
+}
+
+template <typename P>
+void BitmapSprite::renderSpans(P* bufPtr, uint row, uint col, uint count, RowKernel<P> copyKernel, RowKernel<P> blendKernel) {
+    // helper function renders the runs of one image row that fall within columns [col, col + count)
+    const uint8_t* rowPtr = image + row * rowBytes;
+    walkSpans(row, col, count, [&](uint first, uint length, bool opaque) {
+        RowKernel<P> kernel = opaque ? copyKernel : blendKernel;
+        (this->*kernel)(bufPtr + (first - col), rowPtr, first, length);
+    });
+}
+
+template <typename RunFn>
+void BitmapSprite::walkSpans(uint row, uint col, uint count, RunFn fn) {
+    // helper function calls fn(first, length, opaque) for the opaque and translucent runs of an image row,
+    // clipped to columns [col, col + count). Transparent runs are left out.
+    const uint32_t* rowOffsets = spanIndex.get();
+    const uint16_t* runs = (const uint16_t*)(rowOffsets + abs(ht) + 1);
+    const uint16_t* runPtr = runs + rowOffsets[row];
+    const uint16_t* runEnd = runs + rowOffsets[row + 1];
+
+    uint endCol = col + count;
+    uint runStart = 0;
+
+    for (; runPtr < runEnd && runStart < endCol; runPtr++) {
+        uint runType = *runPtr >> 14;
+        uint runEndCol = runStart + (*runPtr & SPAN_LENGTH_MASK);
+
+        if (runType != SPAN_SKIP && runEndCol > col) {
+            uint first = max(runStart, col);
+            uint last = min(runEndCol, endCol);
+            fn(first, last - first, runType == SPAN_COPY);
+        }
+        runStart = runEndCol;
+    }
+}
+
+static inline uint rlePaletteIndex(const uint8_t* src, uint i, bool fill, bool nibbles) {
+    // helper function returns the palette index of pixel i of an RLE run
+    // RLE4 runs pack two indices per byte, high nibble first; encoded runs repeat one byte
+    if (!nibbles) return fill ? *src : src[i];
+    uint8_t pair = fill ? *src : src[i >> 1];
+    return (i & 1) ? (pair & 0x0F) : (pair >> 4);
+}
+
+template <BitmapSprite::Format F, typename RunFn>
+void BitmapSprite::walkRLE(uint row, uint endCol, RunFn fn) {
+    // helper function calls fn(col, length, src, fill) for each run of an RLE row that starts before endCol.
+    // Encoded runs (fill) repeat the byte at src, literal runs list their palette indices from src.
+    // Pixels not covered by a run (end of line, delta and end of bitmap escapes) are transparent.
+    const uint32_t* rowIndex = rleIndex.get() + 2 * row;
+    const uint8_t* ptr = image + rowIndex[0];
+    const uint8_t* end = image + rleBytes;
+    uint x = rowIndex[1];
+    endCol = min(endCol, (uint)wd);
+
+    while (x < endCol && ptr + 2 <= end) {
+        uint n = ptr[0];
+        uint c = ptr[1];
+        ptr += 2;
+        if (n > 0) { // encoded run: n pixels of the index (pair) c
+            fn(x, min(n, wd - x), ptr - 1, true);
+            x += n;
+        } else if (c == 2) { // delta: move right, and down if the next byte is nonzero
+            if (ptr + 2 > end || ptr[1] != 0) break;
+            x += ptr[0];
+            ptr += 2;
+        } else if (c < 2) { // end of line, end of bitmap
+            break;
+        } else { // literal run of c indices, padded to 16 bits
+            uint bytes = (F == RLE8) ? c : (c + 1) / 2;
+            if (ptr + bytes > end) break;
+            fn(x, min(c, wd - x), ptr, false);
+            x += c;
+            ptr += (bytes + 1) & ~1;
+        }
+    }
+}
+
+template <typename P, BitmapSprite::Format F>
+void BitmapSprite::renderRLERow(P* bufPtr, uint row, uint col, uint count, uint8_t spriteAlpha) {
+    // helper function composites the runs of one RLE row that fall within columns [col, col + count)
+    // encoded runs of a single color are filled, or blended with the color from the decoded palette
+    const uint32_t spriteA = spriteAlpha * 257;
+    const PaletteColor* colors = drawColors();
+    const FadeTable* fade = (spriteAlpha != 255 && FadePixel<P>::SUPPORTED) ? FadeTable::find(spriteAlpha) : nullptr;
+    uint endCol = col + count;
+    BlendBatch<P> batch;
+
+    walkRLE<F>(row, endCol, [&](uint start, uint length, const uint8_t* src, bool fill) {
+        uint first = max(start, col);
+        uint last = min(start + length, endCol);
+        if (first >= last) return;
+        P* ptr = bufPtr + (first - col);
+
+        if (fill && (F == RLE8 || (*src >> 4) == (*src & 0x0F))) {
+            const PaletteColor& c = colors[rlePaletteIndex(src, 0, true, F == RLE4)];
+            if (spriteAlpha == 255) {
+                P color = opaqueColor<P>(c);
+                for (uint i = first; i < last; i++) *ptr++ = color;
+                COUNT_STATS(copied, last - first);
+                return;
+            }
+            COUNT_STATS(blended, last - first);
+            if (fade) {
+                for (uint i = first; i < last; i++) FadePixel<P>::blend(ptr++, *fade, c.red, c.green, c.blue);
+            } else {
+                for (uint i = first; i < last; i++) batch.add(ptr++, c.linearRed, c.linearGreen, c.linearBlue, spriteA);
+            }
+            return;
+        }
+
+        if (spriteAlpha == 255) {
+            COUNT_STATS(copied, last - first);
+        } else {
+            COUNT_STATS(blended, last - first);
+        }
+        for (uint i = first - start; i < last - start; i++, ptr++) {
+            const PaletteColor& c = colors[rlePaletteIndex(src, i, fill, F == RLE4)];
+            if (spriteAlpha == 255) {
+                *ptr = opaqueColor<P>(c);
+            } else if (fade) {
+                FadePixel<P>::blend(ptr, *fade, c.red, c.green, c.blue);
+            } else {
+                batch.add(ptr, c.linearRed, c.linearGreen, c.linearBlue, spriteA);
+            }
+        }
+    });
+    batch.flush();
+}
+
+static inline uint32_t spriteFactor(uint8_t alpha) {
+    // helper function returns the sprite alpha as a 16.16 factor, 0x10000 for an opaque sprite
+    return alpha * 257 + (alpha >> 7);
+}
+
+void BitmapSprite::storeLinear(LinearPixel& p, uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    // helper function stores a straight 16-bit linear color with alpha 0..0xFFFF as a premultiplied pixel
+    p.red = (r * (a + 1)) >> 16;
+    p.green = (g * (a + 1)) >> 16;
+    p.blue = (b * (a + 1)) >> 16;
+    p.alpha = a;
+}
+
+template <typename P>
+bool BitmapSprite::renderBlendMode(P* bufRowPtr, int startY, int endY, int rowOrigin, int rowStep, uint col, uint count) {
+    // helper function draws the visible rows of an untransformed sprite with a blend mode other than BLEND_OVER.
+    // The kernels are picked once: BLEND_REPLACE draws every pixel with the opaque row kernel, the other modes
+    // decode up to MODE_CHUNK pixels at a time into linear light with the decoder for the format, then combine
+    // them with the buffer with the blender for the mode.
+    if (format == RLE8 || format == RLE4) {
+        // REPLACE draws the runs like source-over, since they are opaque anyway, leaving the gaps
+        ModeBlender<P> blender = selectBlender<P>();
+        for (int y = startY; y <= endY; y++) {
+            uint row = rowOrigin + rowStep * y;
+            if (blend == BLEND_REPLACE) {
+                if (format == RLE8) {
+                    renderRLERow<P, RLE8>(bufRowPtr, row, col, count, alpha);
+                } else {
+                    renderRLERow<P, RLE4>(bufRowPtr, row, col, count, alpha);
+                }
+            } else if (format == RLE8) {
+                renderRLEBlend<P, RLE8>(bufRowPtr, row, col, count, blender);
+            } else {
+                renderRLEBlend<P, RLE4>(bufRowPtr, row, col, count, blender);
+            }
+            bufRowPtr += matrixWidth;
+        }
+        return 1;
+    }
 
-    rgb24* bufRowPtr = buffer + startX + startY * matrixWidth;
-    rgb24* bufPtr;
+    if (blend == BLEND_REPLACE) {
+        RowKernel<P> kernel = selectKernel<P>(false, alpha != 255);
+        for (int y = startY; y <= endY; y++) {
+            uint segCol = 0;
+            const uint8_t* rowPtr = stream ? streamRow(rowOrigin + rowStep * y, col, count, segCol) : image + (rowOrigin + rowStep * y) * rowBytes;
+            (this->*kernel)(bufRowPtr, rowPtr, col - segCol, count);
+            bufRowPtr += matrixWidth;
+        }
+        return 1;
+    }
+
+    RowDecoder decoder = selectDecoder(alphaChannel);
+    ModeBlender<P> blender = selectBlender<P>();
+    uint32_t spriteA = spriteFactor(alpha);
+    LinearPixel chunk[MODE_CHUNK];
+    auto draw = [&](P* bufPtr, const uint8_t* rowPtr, uint first, uint length) {
+        for (uint done = 0; done < length; done += MODE_CHUNK) {
+            uint n = min(length - done, (uint)MODE_CHUNK);
+            (this->*decoder)(chunk, rowPtr, first + done, n, spriteA);
+            blender(bufPtr + done, chunk, n);
+        }
+    };
 
-    for (int j = startY - y; j <= endY - y; j++) {
-        bufPtr = bufRowPtr;
+    for (int y = startY; y <= endY; y++) {
+        uint row = rowOrigin + rowStep * y;
+        if (stream) {
+            uint segCol;
+            const uint8_t* rowPtr = streamRow(row, col, count, segCol);
+            draw(bufRowPtr, rowPtr, col - segCol, count);
+        } else if (spanIndex) {
+            // transparent runs change nothing in any mode: skip them
+            const uint8_t* rowPtr = image + row * rowBytes;
+            walkSpans(row, col, count, [&](uint first, uint length, bool) {
+                draw(bufRowPtr + (first - col), rowPtr, first, length);
+            });
+        } else {
+            draw(bufRowPtr, image + row * rowBytes, col, count);
+        }
         bufRowPtr += matrixWidth;
-        for (int i = startX - leftval; i <= endX - leftval; i++) {
-            composite(bufPtr++, abs(j), i);
+    }
+    return 1;
+}
+
+BitmapSprite::RowDecoder BitmapSprite::selectDecoder(bool pixelAlpha) {
+    // helper function returns the row decoder specialized for the current format
+    switch (format) {
+        case RGB1: return decoderFor<RGB1>(pixelAlpha);
+        case RGB4: return decoderFor<RGB4>(pixelAlpha);
+        case RGB8: return decoderFor<RGB8>(pixelAlpha);
+        case XRGB16: return decoderFor<XRGB16>(pixelAlpha);
+        case RGB24: return decoderFor<RGB24>(pixelAlpha);
+        case ARGB32: return decoderFor<ARGB32>(pixelAlpha);
+        case XRGB32: return decoderFor<XRGB32>(pixelAlpha);
+        case RGB24A: return decoderFor<RGB24A>(pixelAlpha);
+        case LINEAR64: return decoderFor<LINEAR64>(pixelAlpha);
+        case RLE8: // decoded by renderRLEBlend
+        case RLE4:
+            break;
+    }
+    return nullptr;
+}
+
+template <BitmapSprite::Format F>
+BitmapSprite::RowDecoder BitmapSprite::decoderFor(bool pixelAlpha) {
+    const bool direct = !indexedRows(F);
+    if (pixelAlpha && direct) {
+        if (colorMap) return &BitmapSprite::decodeRow<F, direct, direct>;
+        return &BitmapSprite::decodeRow<F, direct, false>;
+    }
+    if (colorMap && direct) return &BitmapSprite::decodeRow<F, false, direct>;
+    return &BitmapSprite::decodeRow<F, false, false>;
+}
+
+template <BitmapSprite::Format F, bool pixelAlpha, bool colorMapped>
+void BitmapSprite::decodeRow(LinearPixel* out, const uint8_t* rowPtr, uint col, uint count, uint32_t spriteA) {
+    // Row decoder reads `count` consecutive pixels of one image row, starting at `col`, as premultiplied 16-bit
+    // linear color, with the pixel alpha (if pixelAlpha) times the sprite alpha factor spriteA.
+    RowReader rd;
+    seekPixel<F>(rd, rowPtr, col);
+    const ColorMap* colors = colorMap.get();
+
+    for (; count > 0; count--, out++) {
+        uint32_t r, g, b, a;
+        if (F == RGB1 || F == RGB4 || F == RGB8) {
+            const PaletteColor& c = drawColors()[readIndex<F>(rd)];
+            r = c.linearRed;
+            g = c.linearGreen;
+            b = c.linearBlue;
+            a = 0xFFFF;
+        } else {
+            readPixel<F, pixelAlpha>(rd, r, g, b, a);
+            if (colorMapped) mapPixel<F>(*colors, r, g, b);
+            if (F != LINEAR64) {
+                r = decodeGamma8to16(r);
+                g = decodeGamma8to16(g);
+                b = decodeGamma8to16(b);
+                a *= 257;
+            }
+        }
+        storeLinear(*out, r, g, b, (a * spriteA) >> 16);
+    }
+}
+
+template <typename P, BitmapSprite::Format F>
+void BitmapSprite::renderRLEBlend(P* bufPtr, uint row, uint col, uint count, ModeBlender<P> blender) {
+    // helper function draws the runs of one RLE row that fall within columns [col, col + count) with a blend mode,
+    // a chunk of decoded palette colors at a time
+    const PaletteColor* colors = drawColors();
+    uint32_t a = (0xFFFF * spriteFactor(alpha)) >> 16;
+    uint endCol = col + count;
+    LinearPixel chunk[MODE_CHUNK];
+
+    walkRLE<F>(row, endCol, [&](uint start, uint length, const uint8_t* src, bool fill) {
+        uint first = max(start, col);
+        uint last = min(start + length, endCol);
+        for (uint i = first; i < last; i += MODE_CHUNK) {
+            uint n = min(last - i, (uint)MODE_CHUNK);
+            for (uint k = 0; k < n; k++) {
+                const PaletteColor& c = colors[rlePaletteIndex(src, i + k - start, fill, F == RLE4)];
+                storeLinear(chunk[k], c.linearRed, c.linearGreen, c.linearBlue, a);
+            }
+            blender(bufPtr + (i - col), chunk, n);
+        }
+    });
+}
+
+template <typename P>
+BitmapSprite::ModeBlender<P> BitmapSprite::selectBlender() {
+    // helper function returns the blender for the sprite's blend mode; BLEND_OVER has its own kernels
+    switch (blend) {
+        case BLEND_ADD: return &BitmapSprite::blendModeRow<P, BLEND_ADD>;
+        case BLEND_MULTIPLY: return &BitmapSprite::blendModeRow<P, BLEND_MULTIPLY>;
+        case BLEND_SCREEN: return &BitmapSprite::blendModeRow<P, BLEND_SCREEN>;
+        case BLEND_REPLACE: return &BitmapSprite::blendModeRow<P, BLEND_REPLACE>;
+        case BLEND_OVER:
+            break;
+    }
+    return nullptr;
+}
+
+template <BitmapSprite::BlendMode M>
+static inline uint32_t blendChannel(uint32_t s, uint32_t d, uint32_t a) {
+    // helper function combines a premultiplied 16-bit linear source channel s, with alpha a, and a buffer channel d
+    switch (M) {
+        case BitmapSprite::BLEND_ADD:
+            return min(d + s, 0xFFFFu);
+        case BitmapSprite::BLEND_MULTIPLY: { // d * (1 - a + s): white keeps the buffer, black darkens it by a
+                uint32_t f = 0xFFFF - a + s;
+                return ((f + (f >> 15)) * d) >> 16;
+            }
+        case BitmapSprite::BLEND_SCREEN: // d + s - d * s
+            return min(d + s - ((d * s) >> 16), 0xFFFFu);
+        default: // premultiplied over, for faded replaced sprites and their antialiased edges
+            return min(s + (((0xFFFF - a) * d) >> 16), 0xFFFFu);
+    }
+}
+
+template <typename P, BitmapSprite::BlendMode M>
+void BitmapSprite::blendModeRow(P* bufPtr, const LinearPixel* src, uint count) {
+    // Blender combines `count` decoded pixels with consecutive buffer pixels in linear light.
+    // The mode is resolved at compile time, so each blender is a tight loop.
+    for (; count > 0; count--, bufPtr++, src++) {
+        uint32_t a = src->alpha;
+        if (a == 0) continue; // fully transparent pixel: no mode changes the buffer
+        if (M == BLEND_REPLACE && a == 0xFFFF) {
+            *bufPtr = DestPixel<P>::fromLinear16(src->red, src->green, src->blue);
+            COUNT_STATS(copied, 1);
+            continue;
+        }
+
+        uint32_t dr, dg, db;
+        DestPixel<P>::toLinear16(*bufPtr, dr, dg, db);
+        *bufPtr = DestPixel<P>::fromLinear16(blendChannel<M>(src->red, dr, a), blendChannel<M>(src->green, dg, a), blendChannel<M>(src->blue, db, a));
+        COUNT_STATS(blended, 1);
+    }
+}
+
+static inline int64_t floorDiv(int64_t n, int64_t d) {
+    // helper function divides, rounding towards negative infinity
+    int64_t q = n / d;
+    if ((n % d != 0) && ((n < 0) != (d < 0))) q--;
+    return q;
+}
+
+static void clipSpan(int64_t f0, int32_t k, int64_t lo, int64_t hi, int64_t& first, int64_t& last) {
+    // helper function narrows the steps [first, last] to those where lo <= f0 + k * step <= hi
+    if (k == 0) {
+        if (f0 < lo || f0 > hi) last = first - 1;
+    } else if (k > 0) {
+        first = max(first, -floorDiv(f0 - lo, k));
+        last = min(last, floorDiv(hi - f0, k));
+    } else {
+        first = max(first, -floorDiv(f0 - hi, k));
+        last = min(last, floorDiv(lo - f0, k));
+    }
+}
+
+bool BitmapSprite::affineMap(AffineMap& map) {
+    // helper function inverts the sprite transform into steps through the image, once per render.
+    // Trigonometry and division only run here: the kernels step from pixel to pixel with additions.
+    if (transform.scaleX == 0 || transform.scaleY == 0) return 0;
+
+    float angle = transform.angle * (6.2831853f / 65536);
+    float cs = cosf(angle);
+    float sn = sinf(angle);
+    float sx = transform.scaleX / 65536.0f;
+    float sy = transform.scaleY / 65536.0f;
+
+    // screen offsets from the sprite center, rotated back and unscaled: image offsets in 16.16
+    float a = cs / sx * 65536;
+    float b = sn / sx * 65536;
+    float c = -sn / sy * 65536;
+    float d = cs / sy * 65536;
+    const float limit = 1073741824.0f; // keeps stepping within 32 bits
+    if (fabsf(a) > limit || fabsf(b) > limit || fabsf(c) > limit || fabsf(d) > limit) return 0; // too small
+
+    Rect src = source();
+    map.a = roundf(a);
+    map.b = roundf(b);
+    map.c = roundf(c);
+    map.d = roundf(d);
+    map.rowBase = (ht > 0) ? abs(ht) - 1 - src.top : src.top;
+    map.rowStep = (ht > 0) ? -1 : 1;
+    map.colBase = src.left;
+    map.width = src.right - src.left + 1;
+    map.height = src.bottom - src.top + 1;
+    return map.width > 0 && map.height > 0;
+}
+
+BitmapSprite::Rect BitmapSprite::transformedBounds() {
+    // helper function returns the screen rectangle around the transformed sprite, one pixel generous:
+    // renderAffine() clips each row exactly
+    Rect src = source();
+    if (src.right < src.left || transform.scaleX == 0 || transform.scaleY == 0) return {0, 0, -1, -1};
+
+    float hw = (src.right - src.left + 1) * 0.5f;
+    float hh = (src.bottom - src.top + 1) * 0.5f;
+    if (transform.bilinear) { // edge pixels fade out over half a pixel
+        hw += 0.5f;
+        hh += 0.5f;
+    }
+
+    float angle = transform.angle * (6.2831853f / 65536);
+    float cs = cosf(angle);
+    float sn = sinf(angle);
+    float sx = transform.scaleX / 65536.0f;
+    float sy = transform.scaleY / 65536.0f;
+
+    // half extents of the rotated and scaled rectangle
+    float ex = fabsf(cs * sx) * hw + fabsf(sn * sy) * hh;
+    float ey = fabsf(sn * sx) * hw + fabsf(cs * sy) * hh;
+    float cx = transform.x / 65536.0f;
+    float cy = transform.y / 65536.0f;
+
+    Rect rect;
+    rect.left = floorf(cx - ex - 0.5f);
+    rect.right = ceilf(cx + ex - 0.5f);
+    rect.top = floorf(cy - ey - 0.5f);
+    rect.bottom = ceilf(cy + ey - 0.5f);
+    return rect;
+}
+
+template <typename P>
+bool BitmapSprite::renderAffine(P* buffer, const Rect& rect, const Rect& clip) {
+    // helper function renders the transformed sprite within rect (from transformedBounds), the clip rectangle
+    // and the display. Each row is clipped to the pixels whose centers map into the image, so only covered
+    // pixels are visited, then the kernel steps through the image incrementally.
+    if (stream || format == RLE8 || format == RLE4) return 0; // rows are not randomly accessible
+
+    AffineMap map;
+    if (!affineMap(map)) return 0;
+
+    int startY = max(max(rect.top, clip.top), 0);
+    int endY = min(min(rect.bottom, clip.bottom), matrixHeight - 1);
+    int startX = max(max(rect.left, clip.left), 0);
+    int endX = min(min(rect.right, clip.right), matrixWidth - 1);
+
+    if (startX > endX) return 0;
+    if (startY > endY) return 0;
+    if (alpha != 255 && !transform.bilinear && FadePixel<P>::SUPPORTED) prepareFade(rect);
+
+    // image coordinates (16.16) of the samples that touch the frame: pixel centers inside it for nearest
+    // sampling, and up to half a pixel outside it for bilinear sampling
+    int64_t uMin = 0;
+    int64_t vMin = 0;
+    int64_t uMax = ((int64_t)map.width << 16) - 1;
+    int64_t vMax = ((int64_t)map.height << 16) - 1;
+    if (transform.bilinear) {
+        uMin -= 0x7FFF;
+        vMin -= 0x7FFF;
+        uMax += 0x8000;
+        vMax += 0x8000;
+    }
+
+    // blend modes other than BLEND_OVER decode a chunk of samples at a time, then combine them with the buffer;
+    // BLEND_REPLACE samples the image as opaque, so at sprite alpha 255 only the antialiased edges of bilinear
+    // sprites are blended
+    AffineKernel<P> kernel = nullptr;
+    AffineDecoder decoder = nullptr;
+    ModeBlender<P> blender = nullptr;
+    if (blend == BLEND_OVER) {
+        kernel = selectAffineKernel<P>(transform.bilinear);
+    } else {
+        decoder = selectAffineDecoder(transform.bilinear);
+        blender = selectBlender<P>();
+    }
+    bool pixelAlpha = alphaChannel && blend != BLEND_REPLACE;
+    uint32_t spriteA = spriteFactor(alpha);
+    LinearPixel chunk[MODE_CHUNK];
+
+    int64_t dx = ((int64_t)startX << 16) + 0x8000 - transform.x; // first pixel center, from the sprite center
+    int64_t uCenter = (int64_t)map.width << 15;
+    int64_t vCenter = (int64_t)map.height << 15;
+    P* bufRowPtr = buffer + startY * matrixWidth;
+    bool drawn = false;
+
+    for (int y = startY; y <= endY; y++, bufRowPtr += matrixWidth) {
+        int64_t dy = ((int64_t)y << 16) + 0x8000 - transform.y;
+        int64_t u = ((map.a * dx + map.b * dy) >> 16) + uCenter;
+        int64_t v = ((map.c * dx + map.d * dy) >> 16) + vCenter;
+
+        int64_t first = 0;
+        int64_t last = endX - startX;
+        clipSpan(u, map.a, uMin, uMax, first, last);
+        clipSpan(v, map.c, vMin, vMax, first, last);
+        if (first > last) continue;
+        COUNT_STATS(pixels, last - first + 1);
+
+        if (kernel) {
+            (this->*kernel)(bufRowPtr + startX + first, u + map.a * first, v + map.c * first, last - first + 1, map);
+        } else {
+            for (int64_t i = first; i <= last; i += MODE_CHUNK) {
+                uint n = min(last - i + 1, (int64_t)MODE_CHUNK);
+                (this->*decoder)(chunk, u + map.a * i, v + map.c * i, n, map, spriteA, pixelAlpha);
+                blender(bufRowPtr + startX + i, chunk, n);
+            }
         }
+        drawn = true;
+    }
+    return drawn;
+}
+
+template <typename P>
+BitmapSprite::AffineKernel<P> BitmapSprite::selectAffineKernel(bool bilinear) {
+    // helper function returns the affine kernel specialized for the current format and sampling
+    switch (format) {
+        case RGB1: return affineKernelFor<P, RGB1>(bilinear);
+        case RGB4: return affineKernelFor<P, RGB4>(bilinear);
+        case RGB8: return affineKernelFor<P, RGB8>(bilinear);
+        case XRGB16: return affineKernelFor<P, XRGB16>(bilinear);
+        case RGB24: return affineKernelFor<P, RGB24>(bilinear);
+        case ARGB32: return affineKernelFor<P, ARGB32>(bilinear);
+        case XRGB32: return affineKernelFor<P, XRGB32>(bilinear);
+        case RGB24A: return affineKernelFor<P, RGB24A>(bilinear);
+        case LINEAR64: return affineKernelFor<P, LINEAR64>(bilinear);
+        case RLE8: // not supported by renderAffine
+        case RLE4:
+            break;
+    }
+    return nullptr;
+}
+
+template <typename P, BitmapSprite::Format F>
+BitmapSprite::AffineKernel<P> BitmapSprite::affineKernelFor(bool bilinear) {
+    const bool direct = !indexedRows(F);
+    if (colorMap && direct) return samplingKernelFor<P, F, direct>(bilinear);
+    return samplingKernelFor<P, F, false>(bilinear);
+}
+
+template <typename P, BitmapSprite::Format F, bool colorMapped>
+BitmapSprite::AffineKernel<P> BitmapSprite::samplingKernelFor(bool bilinear) {
+    if (bilinear) return &BitmapSprite::affineRowBilinear<P, F, colorMapped>;
+    return &BitmapSprite::affineRowNearest<P, F, colorMapped>;
+}
+
+template <typename P, BitmapSprite::Format F, bool colorMapped>
+void BitmapSprite::affineRowNearest(P* bufPtr, int32_t u, int32_t v, uint count, const AffineMap& map) {
+    // Affine kernel composites the image pixel under each of `count` screen pixel centers, starting at
+    // image coordinates u, v (16.16) and stepping by map.a, map.c. The row is clipped, so all samples are inside.
+    const FadeTable* fade = (alpha != 255 && F != LINEAR64 && FadePixel<P>::SUPPORTED) ? FadeTable::find(alpha) : nullptr;
+    const ColorMap* colors = colorMap.get();
+    BlendBatch<P> batch;
+
+    for (; count > 0; count--, bufPtr++, u += map.a, v += map.c) {
+        const uint8_t* rowPtr = image + (map.rowBase + map.rowStep * (v >> 16)) * rowBytes;
+        RowReader rd;
+        seekPixel<F>(rd, rowPtr, map.colBase + (u >> 16));
+
+        if (F == RGB1 || F == RGB4 || F == RGB8) { // opaque, with a decoded palette
+            const PaletteColor& c = drawColors()[readIndex<F>(rd)];
+            if (alpha == 255) {
+                *bufPtr = opaqueColor<P>(c);
+                COUNT_STATS(copied, 1);
+            } else if (fade) {
+                FadePixel<P>::blend(bufPtr, *fade, c.red, c.green, c.blue);
+                COUNT_STATS(blended, 1);
+            } else {
+                batch.add(bufPtr, c.linearRed, c.linearGreen, c.linearBlue, alpha * 257);
+                COUNT_STATS(blended, 1);
+            }
+            continue;
+        }
+
+        uint32_t r, g, b, a;
+        if (alphaChannel) {
+            readPixel<F, true>(rd, r, g, b, a);
+        } else {
+            readPixel<F, false>(rd, r, g, b, a);
+        }
+        if (colorMapped) mapPixel<F>(*colors, r, g, b);
+
+        if (F == LINEAR64) { // source is already linear, alpha is 16-bit
+            if (alpha != 255) a = a * alpha / 255;
+            if (a == 0) continue;
+            if (a == 0xFFFF) {
+                *bufPtr = DestPixel<P>::fromLinear16(r, g, b);
+                COUNT_STATS(copied, 1);
+            } else {
+                batch.add(bufPtr, r, g, b, a);
+                COUNT_STATS(blended, 1);
+            }
+            continue;
+        }
+
+        if (a == 0) continue; // fully transparent pixel
+        if (fade && a == 255) {
+            FadePixel<P>::blend(bufPtr, *fade, r, g, b);
+            COUNT_STATS(blended, 1);
+            continue;
+        }
+        a = fade ? fade->pixel[a] : a * alpha * 257 / 255; // expands 0xFF * 0xFF to 0xFFFF
+
+        if (a == 0xFFFF) {
+            *bufPtr = DestPixel<P>::fromSRGB8(r, g, b);
+            COUNT_STATS(copied, 1);
+        } else {
+            batch.add(bufPtr, decodeGamma8to16(r), decodeGamma8to16(g), decodeGamma8to16(b), a);
+            COUNT_STATS(blended, 1);
+        }
+    }
+    batch.flush();
+}
+
+template <typename P, BitmapSprite::Format F, bool colorMapped>
+void BitmapSprite::affineRowBilinear(P* bufPtr, int32_t u, int32_t v, uint count, const AffineMap& map) {
+    // Affine kernel composites the four image pixels around each of `count` screen pixel centers, weighted by
+    // distance. Colors are interpolated in linear light, premultiplied by alpha; pixels outside the frame
+    // count as transparent, so the edges of the sprite are antialiased.
+    const uint32_t spriteA = spriteFactor(alpha); // 0x10000 for an opaque sprite
+
+    for (; count > 0; count--, bufPtr++, u += map.a, v += map.c) {
+        uint32_t r, g, b, a;
+        sampleBilinear<F, colorMapped>(map, u, v, r, g, b, a, alphaChannel);
+        if (spriteA != 0x10000) {
+            a = (a * spriteA) >> 16;
+            r = (r * spriteA) >> 16;
+            g = (g * spriteA) >> 16;
+            b = (b * spriteA) >> 16;
+        }
+        if (a == 0) continue;
+
+        // premultiplied over: source plus the uncovered part of the destination
+        uint32_t dr, dg, db;
+        DestPixel<P>::toLinear16(*bufPtr, dr, dg, db);
+        uint32_t keep = 0xFFFF - a;
+        *bufPtr = DestPixel<P>::fromLinear16(min(r + ((keep * dr) >> 16), 0xFFFFu), min(g + ((keep * dg) >> 16), 0xFFFFu), min(b + ((keep * db) >> 16), 0xFFFFu));
+        if (a == 0xFFFF) {
+            COUNT_STATS(copied, 1);
+        } else {
+            COUNT_STATS(blended, 1);
+        }
+    }
+}
+
+template <BitmapSprite::Format F, bool colorMapped>
+void BitmapSprite::sampleBilinear(const AffineMap& map, int32_t u, int32_t v, uint32_t& r, uint32_t& g, uint32_t& b, uint32_t& a, bool pixelAlpha) {
+    // helper function interpolates the four image pixels around image coordinates u, v (16.16) as premultiplied
+    // 16-bit linear color and alpha
+
+    // sample grid position: the image pixel centers are at half-pixel offsets
+    int32_t us = u - 0x8000;
+    int32_t vs = v - 0x8000;
+    int col = us >> 16;
+    int row = vs >> 16;
+    uint32_t fx = (us >> 8) & 0xFF;
+    uint32_t fy = (vs >> 8) & 0xFF;
+    const uint32_t weights[4] = {(256 - fx) * (256 - fy), fx * (256 - fy), (256 - fx) * fy, fx * fy};
+
+    // weights add up to 0x10000, so the sums stay within 32 bits
+    uint32_t sumR = 0, sumG = 0, sumB = 0, sumA = 0;
+    for (int i = 0; i < 4; i++) {
+        if (weights[i] == 0) continue;
+        uint32_t pr, pg, pb, pa;
+        readLinear<F, colorMapped>(map, col + (i & 1), row + (i >> 1), pr, pg, pb, pa, pixelAlpha);
+        if (pa == 0) continue;
+        sumR += weights[i] * ((pr * (pa + 1)) >> 16);
+        sumG += weights[i] * ((pg * (pa + 1)) >> 16);
+        sumB += weights[i] * ((pb * (pa + 1)) >> 16);
+        sumA += weights[i] * pa;
+    }
+
+    a = sumA >> 16;
+    r = sumR >> 16;
+    g = sumG >> 16;
+    b = sumB >> 16;
+}
+
+template <BitmapSprite::Format F, bool colorMapped>
+void BitmapSprite::readLinear(const AffineMap& map, int col, int row, uint32_t& r, uint32_t& g, uint32_t& b, uint32_t& a, bool pixelAlpha) {
+    // helper function reads a frame pixel as 16-bit linear color and alpha; pixels outside the frame are transparent.
+    // Without pixelAlpha, the alpha channel is ignored.
+    if (col < 0 || row < 0 || col >= map.width || row >= map.height) {
+        r = g = b = 0;
+        a = 0;
+        return;
+    }
+
+    RowReader rd;
+    seekPixel<F>(rd, image + (map.rowBase + map.rowStep * row) * rowBytes, map.colBase + col);
+    if (F == RGB1 || F == RGB4 || F == RGB8) {
+        const PaletteColor& c = drawColors()[readIndex<F>(rd)];
+        r = c.linearRed;
+        g = c.linearGreen;
+        b = c.linearBlue;
+        a = 0xFFFF;
+        return;
+    }
+    if (pixelAlpha) {
+        readPixel<F, true>(rd, r, g, b, a);
+    } else {
+        readPixel<F, false>(rd, r, g, b, a);
+    }
+    if (colorMapped) mapPixel<F>(*colorMap, r, g, b);
+
+    if (F != LINEAR64) {
+        r = decodeGamma8to16(r);
+        g = decodeGamma8to16(g);
+        b = decodeGamma8to16(b);
+        a *= 257;
+    }
+}
+
+BitmapSprite::AffineDecoder BitmapSprite::selectAffineDecoder(bool bilinear) {
+    // helper function returns the affine decoder specialized for the current format and sampling
+    switch (format) {
+        case RGB1: return affineDecoderFor<RGB1>(bilinear);
+        case RGB4: return affineDecoderFor<RGB4>(bilinear);
+        case RGB8: return affineDecoderFor<RGB8>(bilinear);
+        case XRGB16: return affineDecoderFor<XRGB16>(bilinear);
+        case RGB24: return affineDecoderFor<RGB24>(bilinear);
+        case ARGB32: return affineDecoderFor<ARGB32>(bilinear);
+        case XRGB32: return affineDecoderFor<XRGB32>(bilinear);
+        case RGB24A: return affineDecoderFor<RGB24A>(bilinear);
+        case LINEAR64: return affineDecoderFor<LINEAR64>(bilinear);
+        case RLE8: // not supported by renderAffine
+        case RLE4:
+            break;
+    }
+    return nullptr;
+}
+
+template <BitmapSprite::Format F>
+BitmapSprite::AffineDecoder BitmapSprite::affineDecoderFor(bool bilinear) {
+    const bool direct = !indexedRows(F);
+    if (colorMap && direct) {
+        if (bilinear) return &BitmapSprite::affineDecodeBilinear<F, direct>;
+        return &BitmapSprite::affineDecodeNearest<F, direct>;
+    }
+    if (bilinear) return &BitmapSprite::affineDecodeBilinear<F, false>;
+    return &BitmapSprite::affineDecodeNearest<F, false>;
+}
+
+template <BitmapSprite::Format F, bool colorMapped>
+void BitmapSprite::affineDecodeNearest(LinearPixel* out, int32_t u, int32_t v, uint count, const AffineMap& map, uint32_t spriteA, bool pixelAlpha) {
+    // Affine decoder reads the image pixel under each of `count` screen pixel centers, stepping as in
+    // affineRowNearest, as premultiplied 16-bit linear color with its alpha times the sprite alpha factor spriteA
+    for (; count > 0; count--, out++, u += map.a, v += map.c) {
+        uint32_t r, g, b, a;
+        readLinear<F, colorMapped>(map, u >> 16, v >> 16, r, g, b, a, pixelAlpha);
+        storeLinear(*out, r, g, b, (a * spriteA) >> 16);
+    }
+}
+
+template <BitmapSprite::Format F, bool colorMapped>
+void BitmapSprite::affineDecodeBilinear(LinearPixel* out, int32_t u, int32_t v, uint count, const AffineMap& map, uint32_t spriteA, bool pixelAlpha) {
+    // Affine decoder interpolates the samples of `count` screen pixel centers, as in affineRowBilinear
+    for (; count > 0; count--, out++, u += map.a, v += map.c) {
+        uint32_t r, g, b, a;
+        sampleBilinear<F, colorMapped>(map, u, v, r, g, b, a, pixelAlpha);
+        out->red = (r * spriteA) >> 16;
+        out->green = (g * spriteA) >> 16;
+        out->blue = (b * spriteA) >> 16;
+        out->alpha = (a * spriteA) >> 16;
+    }
+}
+
+template <typename P>
+BitmapSprite::RowKernel<P> BitmapSprite::selectKernel(bool pixelAlpha, bool spriteAlpha) {
+    // helper function returns the row kernel specialized for the current format and alpha settings
+    // pixelAlpha selects a kernel that reads per-pixel alpha; without it, pixels are treated as opaque.
+    // spriteAlpha selects a kernel that fades the pixels by the sprite alpha.
+    switch (format) {
+        case RGB1: return kernelFor<P, RGB1>(pixelAlpha, spriteAlpha);
+        case RGB4: return kernelFor<P, RGB4>(pixelAlpha, spriteAlpha);
+        case RGB8: return kernelFor<P, RGB8>(pixelAlpha, spriteAlpha);
+        case XRGB16: return kernelFor<P, XRGB16>(pixelAlpha, spriteAlpha);
+        case RGB24: return kernelFor<P, RGB24>(pixelAlpha, spriteAlpha);
+        case ARGB32: return kernelFor<P, ARGB32>(pixelAlpha, spriteAlpha);
+        case XRGB32: return kernelFor<P, XRGB32>(pixelAlpha, spriteAlpha);
+        case RGB24A: return kernelFor<P, RGB24A>(pixelAlpha, spriteAlpha);
+        case LINEAR64: return kernelFor<P, LINEAR64>(pixelAlpha, spriteAlpha);
+        case RLE8: // decoded by renderRLERow
+        case RLE4:
+            break;
+    }
+    return nullptr;
+}
+
+template <typename P, BitmapSprite::Format F>
+BitmapSprite::RowKernel<P> BitmapSprite::kernelFor(bool pixelAlpha, bool spriteAlpha) {
+    const bool direct = !indexedRows(F);
+    if (colorMap && direct) return alphaKernelFor<P, F, direct>(pixelAlpha, spriteAlpha);
+    return alphaKernelFor<P, F, false>(pixelAlpha, spriteAlpha);
+}
+
+template <typename P, BitmapSprite::Format F, bool colorMapped>
+BitmapSprite::RowKernel<P> BitmapSprite::alphaKernelFor(bool pixelAlpha, bool spriteAlpha) {
+    if (pixelAlpha) {
+        if (!spriteAlpha) return &BitmapSprite::compositeRow<P, F, true, false, colorMapped>;
+        return &BitmapSprite::compositeRow<P, F, true, true, colorMapped>;
+    } else {
+        if (!spriteAlpha) return &BitmapSprite::compositeRow<P, F, false, false, colorMapped>;
+        return &BitmapSprite::compositeRow<P, F, false, true, colorMapped>;
+    }
+}
+
+template <typename P, BitmapSprite::Format F, bool pixelAlpha, bool spriteAlpha, bool colorMapped>
+void BitmapSprite::compositeRow(P* bufPtr, const uint8_t* rowPtr, uint col, uint count) {
+    // Row kernel performs alpha compositing on `count` consecutive pixels of one image row, starting at `col`,
+    // using pixel alpha value (if pixelAlpha) times overall sprite alpha (if spriteAlpha), after passing each
+    // pixel through the color transform (if colorMapped).
+    // The format and destination pixel type are resolved at compile time, so each combination is a tight loop.
+    RowReader rd;
+    seekPixel<F>(rd, rowPtr, col);
+    const ColorMap* colors = colorMap.get();
+
+    if (F == RGB24A && std::is_same<P, rgb24>::value && !pixelAlpha && !spriteAlpha && !colorMapped) {
+        // converted rows are stored as rgb24, so opaque pixels are copied straight into the buffer
+        static_assert(sizeof(rgb24) == 3, "rgb24 must be packed");
+        memcpy(bufPtr, rowPtr + col * 3, count * 3);
+        COUNT_STATS(copied, count);
+        return;
+    }
+
+    // without an alpha channel, the blend factor is the same for every pixel
+    const uint32_t spriteA = alpha * 257; // equals 255 * alpha * 257 / 255
+
+    // a fade table prepared by the render call has the blend of every channel value multiplied out
+    const FadeTable* fade = (spriteAlpha && F != LINEAR64 && FadePixel<P>::SUPPORTED) ? FadeTable::find(alpha) : nullptr;
+    if (fade && !pixelAlpha) {
+        COUNT_STATS(blended, count);
+        for (; count > 0; count--, bufPtr++) {
+            if (F == RGB1 || F == RGB4 || F == RGB8) {
+                const PaletteColor& c = drawColors()[readIndex<F>(rd)];
+                FadePixel<P>::blend(bufPtr, *fade, c.red, c.green, c.blue);
+            } else {
+                uint32_t r, g, b, a;
+                readPixel<F, false>(rd, r, g, b, a);
+                if (colorMapped) mapPixel<F>(*colors, r, g, b);
+                FadePixel<P>::blend(bufPtr, *fade, r, g, b);
+            }
+        }
+        return;
+    }
+
+    // opaque pixels are written immediately, translucent ones are queued and blended several at a time
+    BlendBatch<P> batch;
+
+    for (; count > 0; count--, bufPtr++) {
+        if (F == RGB1 || F == RGB4 || F == RGB8) {
+            // indexed images have no alpha channel, and their palette is decoded once: no gamma table lookups
+            const PaletteColor& c = drawColors()[readIndex<F>(rd)];
+            if (spriteAlpha) {
+                batch.add(bufPtr, c.linearRed, c.linearGreen, c.linearBlue, spriteA);
+                COUNT_STATS(blended, 1);
+            } else {
+                *bufPtr = opaqueColor<P>(c);
+                COUNT_STATS(copied, 1);
+            }
+            continue;
+        }
+
+        uint32_t r, g, b, a;
+        readPixel<F, pixelAlpha>(rd, r, g, b, a);
+        if (colorMapped) mapPixel<F>(*colors, r, g, b);
+
+        if (F == LINEAR64) { // source is already linear, alpha is 16-bit
+            if (pixelAlpha) {
+                if (a == 0) continue; // fully transparent pixel
+                if (spriteAlpha) a = a * alpha / 255;
+            } else {
+                a = spriteAlpha ? spriteA : 0xFFFF;
+            }
+            if (a == 0xFFFF) {
+                *bufPtr = DestPixel<P>::fromLinear16(r, g, b);
+                COUNT_STATS(copied, 1);
+            } else {
+                batch.add(bufPtr, r, g, b, a);
+                COUNT_STATS(blended, 1);
+            }
+            continue;
+        }
+
+        if (pixelAlpha) {
+            if (a == 0) continue; // fully transparent pixel
+            if (fade && a == 255) {
+                FadePixel<P>::blend(bufPtr, *fade, r, g, b);
+                COUNT_STATS(blended, 1);
+                continue;
+            }
+            if (spriteAlpha) {
+                a = fade ? fade->pixel[a] : a * alpha * 257 / 255; // expands 0xFF * 0xFF to 0xFFFF
+            } else {
+                a = a * 257;
+            }
+        } else {
+            if (!spriteAlpha) { // opaque pixel, opaque sprite
+                *bufPtr = DestPixel<P>::fromSRGB8(r, g, b);
+                COUNT_STATS(copied, 1);
+                continue;
+            }
+            a = spriteA;
+        }
+
+        if (a == 0xFFFF) {
+            *bufPtr = DestPixel<P>::fromSRGB8(r, g, b);
+            COUNT_STATS(copied, 1);
+        } else {
+            batch.add(bufPtr, decodeGamma8to16(r), decodeGamma8to16(g), decodeGamma8to16(b), a);
+            COUNT_STATS(blended, 1);
+        }
+    }
+    batch.flush();
+}
+
+template <BitmapSprite::Format F>
+void BitmapSprite::seekPixel(RowReader& rd, const uint8_t* rowPtr, uint col) {
+    // helper function positions a row reader at pixel `col` of an image row
+    rd.pixPtr = rowPtr;
+    rd.alphaPtr = nullptr;
+    rd.bitMask = 0;
+    rd.lowNibble = false;
+
+    switch (F) {
+        case RGB1: rd.pixPtr += col >> 3; rd.bitMask = 0x80 >> (col & 7); break;
+        case RGB4: rd.pixPtr += col >> 1; rd.lowNibble = col & 1; break;
+        case RGB8: rd.pixPtr += col; break;
+        case XRGB16: rd.pixPtr += col * 2; break;
+        case RGB24: rd.pixPtr += col * 3; break;
+        case ARGB32: rd.pixPtr += col * 4; break;
+        case XRGB32: rd.pixPtr += col * 4; break;
+        case RGB24A: rd.pixPtr += col * 3; rd.alphaPtr = rowPtr + wd * 3 + col; break;
+        case LINEAR64: rd.pixPtr += col * 8; break;
+        case RLE8: // read through walkRLE, not per pixel
+        case RLE4:
+            break;
+    }
+}
+
+template <BitmapSprite::Format F>
+uint BitmapSprite::readIndex(RowReader& rd) {
+    // helper function reads the palette index under the row reader of an indexed image and advances it
+    uint c = 0;
+
+    switch (F) {
+        case RGB1: // 1bpp
+            c = (*rd.pixPtr & rd.bitMask) ? 1 : 0;
+            rd.bitMask >>= 1;
+            if (rd.bitMask == 0) {
+                rd.bitMask = 0x80;
+                rd.pixPtr++;
+            }
+            break;
+        case RGB4: // 4bpp
+            if (rd.lowNibble) {
+                c = (*rd.pixPtr & 0x0F);
+                rd.pixPtr++;
+            } else {
+                c = (*rd.pixPtr & 0xF0) >> 4;
+            }
+            rd.lowNibble = !rd.lowNibble;
+            break;
+        case RGB8: // 8bpp
+            c = *rd.pixPtr++;
+            break;
+        default:
+            break;
     }
-    return 1;
+    return c;
 }
 
-void BitmapSprite::composite(rgb24* bufPtr, uint row, uint col) {
-    // helper function performs alpha compositing operation on a single pixel
-    // using pixel alpha value times overall sprite alpha
-    uint32_t r = 0, g = 0, b = 0, a = 255;
+template <BitmapSprite::Format F, bool pixelAlpha>
+void BitmapSprite::readPixel(RowReader& rd, uint32_t& r, uint32_t& g, uint32_t& b, uint32_t& a) {
+    // helper function reads the pixel under a row reader and advances it to the next pixel
+    // color is 8-bit sRGB, except LINEAR64 which returns 16-bit linear color and alpha
+    const uint8_t* pixPtr = rd.pixPtr;
+    a = 255;
 
-    switch (format) {
-        case RGB1: { // 1bpp, indexed
-                uint8_t* pixPtr = image + row * rowBytes + (col >> 3);
-                int bitindex = 7 - (col & 7);
-                uint8_t c = (*pixPtr & (1 << bitindex)) >> bitindex;
-                uint8_t* palPtr = palette + c * 4;
-                b = *palPtr++;
-                g = *palPtr++;
-                r = *palPtr++;
-            } break;
-        case RGB4: { // 4bpp, indexed
-                uint8_t* pixPtr = image + row * rowBytes + (col >> 1);
-                uint8_t c;
-                if (col & 1) { // low nibble
-                    c = (*pixPtr & 0x0F);
-                } else { // high nibble
-                    c = (*pixPtr & 0xF0) >> 4;
-                }
-                uint8_t* palPtr = palette + c * 4;
-                b = *palPtr++;
-                g = *palPtr++;
-                r = *palPtr++;
-            } break;
+    switch (F) {
+        case RGB1: // 1bpp, indexed
+        case RGB4: // 4bpp, indexed
         case RGB8: { // 8bpp, indexed
-                uint8_t* pixPtr = image + row * rowBytes + col;
-                uint8_t c = *pixPtr;
-                uint8_t* palPtr = palette + c * 4;
-                b = *palPtr++;
-                g = *palPtr++;
-                r = *palPtr++;
+                const PaletteColor& c = paletteColors.get()[readIndex<F>(rd)];
+                r = c.red;
+                g = c.green;
+                b = c.blue;
             } break;
         case XRGB16: { // 16bpp, arbitrary bitmask with transparency
-                uint8_t* pixPtr = image + row * rowBytes + col * 2;
                 uint32_t pixWord = read16(pixPtr);
+                rd.pixPtr += 2;
                 r = ((pixWord & rMask) * rScale) >> rShift;
                 g = ((pixWord & gMask) * gScale) >> gShift;
                 b = ((pixWord & bMask) * bScale) >> bShift;
-                if (alphaChannel) a = ((pixWord & aMask) * aScale) >> aShift;
+                if (pixelAlpha) a = ((pixWord & aMask) * aScale) >> aShift;
             } break;
         case RGB24: { // 24bpp, R8G8B8
-                uint8_t* pixPtr = image + row * rowBytes + col * 3;
-                b = *pixPtr++;
-                g = *pixPtr++;
-                r = *pixPtr++;
+                b = pixPtr[0];
+                g = pixPtr[1];
+                r = pixPtr[2];
+                rd.pixPtr += 3;
             } break;
         case ARGB32: { // 32bpp, R8G8B8 or A8R8G8B8
-                uint8_t* pixPtr = image + row * rowBytes + col * 4;
-                b = *pixPtr++;
-                g = *pixPtr++;
-                r = *pixPtr++;
-                if (alphaChannel) a = *pixPtr;
+                b = pixPtr[0];
+                g = pixPtr[1];
+                r = pixPtr[2];
+                if (pixelAlpha) a = pixPtr[3];
+                rd.pixPtr += 4;
             } break;
         case XRGB32: { // 32bpp, arbitrary bitmask with transparency
-                uint8_t* pixPtr = image + row * rowBytes + col * 4;
                 uint32_t pixWord = read32(pixPtr);
+                rd.pixPtr += 4;
                 r = ((uint64_t)(pixWord & rMask) * rScale) >> rShift;
                 g = ((uint64_t)(pixWord & gMask) * gScale) >> gShift;
                 b = ((uint64_t)(pixWord & bMask) * bScale) >> bShift;
-                if (alphaChannel) a = ((uint64_t)(pixWord & aMask) * aScale) >> aShift;
+                if (pixelAlpha) a = ((uint64_t)(pixWord & aMask) * aScale) >> aShift;
+            } break;
+        case RGB24A: { // converted: rgb24 row followed by alpha row
+                r = pixPtr[0];
+                g = pixPtr[1];
+                b = pixPtr[2];
+                rd.pixPtr += 3;
+                if (pixelAlpha) a = *rd.alphaPtr++;
             } break;
+        case LINEAR64: { // converted: 16-bit linear RGBA
+                const uint16_t* linPtr = (const uint16_t*)pixPtr;
+                r = linPtr[0];
+                g = linPtr[1];
+                b = linPtr[2];
+                a = pixelAlpha ? linPtr[3] : 0xFFFF;
+                rd.pixPtr += 8;
+            } break;
+        case RLE8: // read through walkRLE, not per pixel
+        case RLE4:
+            break;
+    }
+}
+
+void BitmapSprite::loadBitmap(const char* filename, void* destination, size_t allocatedSize, LoadMode mode) {
+    // helper function loads the whole image at once, for the constructors
+    if (beginLoad(filename, destination, allocatedSize, mode)) continueLoad(SIZE_MAX);
+}
+
+bool BitmapSprite::beginLoad(const char* filename, LoadMode mode) {
+    // Starts loading an image into dynamically allocated memory, like the constructor, without blocking:
+    // call continueLoad() or continueLoadFor() from the render loop until it returns LOAD_READY or LOAD_FAILED.
+    // The sprite renders nothing until then. Returns 0 if the load failed already.
+    return beginLoad(filename, nullptr, 0, mode);
+}
+
+bool BitmapSprite::beginLoad(const char* filename, void* destination, size_t allocatedSize, LoadMode mode) {
+    // Starts loading an image into a statically allocated memory range, like the constructor, without blocking.
+    // Any previous image is released; position, alpha, blend mode and frame are kept.
+    // Pre-baked images (see bake()) are loaded as they were baked, whatever the mode.
+    // Only this sprite can continue the load: a copy made before it finishes renders nothing, and its
+    // continueLoad() returns LOAD_FAILED. Copy the sprite once it is LOAD_READY instead.
+    clearImage();
+
+    loading = std::make_shared<LoadState>();
+    loadCopy = CopyMark();
+    LoadState& ld = *loading;
+    ld.mode = mode;
+    ld.destination = (uint8_t*)destination;
+    ld.allocatedSize = allocatedSize;
+    status = LOAD_PENDING;
+
+    if (mode == LOAD_STREAM) {
+        // the header is read now, the rows are only scanned for alpha data
+        if (loadStream(filename, destination, allocatedSize)) {
+            ld.stage = STAGE_SCAN;
+            ld.unusedMask = unusedAlphaMask();
+            return 1;
+        }
+        if (format == RLE8 || format == RLE4 || baked) return beginLoad(filename, destination, allocatedSize, LOAD_BMP);
+        failLoad();
+        return 0;
+    }
+
+    ld.file = SD.open(filename);
+
+    if (!ld.file) {
+        Serial.println("Error: Could not open file.");
+        failLoad();
+        return 0;
+    }
+
+    fsize = ld.file.size();
+
+    if (fsize < 54) { // smallest BMP header
+        Serial.println("Error: Unsupported file format.");
+        failLoad();
+        return 0;
+    }
+
+    if (destination) {
+        if (fsize > allocatedSize) {
+            Serial.println("Error: File too large.");
+            failLoad();
+            return 0;
+        }
+
+        // note: since the memory is statically allocated, do not initialize the shared_ptr.
+        // when converting, read the file into the end of the range and convert into the start
+        ld.ptr = (uint8_t*)destination;
+        if (mode != LOAD_BMP) ld.ptr += allocatedSize - fsize;
+    } else {
+        // dynamically allocate array to hold file content
+        // use shared_ptr so multiple sprites can point to the same data
+        bmpfile.reset(new uint8_t[fsize], std::default_delete<uint8_t[]>());
+
+        if (!bmpfile) {
+            Serial.println("Error: Failed to allocate memory.");
+            failLoad();
+            return 0;
+        }
+        ld.ptr = bmpfile.get();
+    }
+    return 1;
+}
+
+BitmapSprite::LoadStatus BitmapSprite::continueLoad(size_t maxBytes) {
+    // Advances a load started by beginLoad() by about maxBytes: bytes read from the file, or bytes of image rows
+    // scanned, converted or indexed. Each call makes some progress, even with a small maxBytes.
+    // Returns LOAD_PENDING until the sprite is ready to render.
+    if (!loading) return status;
+    if (loadCopy.copied) {
+        Serial.println("Error: Load was started by another sprite.");
+        return failLoad();
+    }
+    LoadState& ld = *loading;
+    uint rows = abs(ht);
+    size_t used = 0;
+
+    do {
+        switch (ld.stage) {
+            case STAGE_READ: {
+                    size_t n = min(fsize - ld.done, max(maxBytes - used, (size_t)LOAD_STEP_BYTES));
+                    uint8_t* ptr = ld.ptr + ld.done;
+
+                    if (ld.file.read(ptr, n) != (int)n) {
+                        Serial.println("Error: Could not read file.");
+                        return failLoad();
+                    }
+
+                    // Flush cache just in case...
+                    if ((uintptr_t)ptr >= 0x20200000u) arm_dcache_flush_delete(ptr, n);
+
+                    ld.done += n;
+                    used += n;
+                    if (ld.done == fsize) {
+                        ld.file.close();
+                        ld.stage = STAGE_PARSE;
+                    }
+                } break;
+            case STAGE_PARSE:
+                if (isBaked(ld.ptr, fsize)) {
+                    // pre-baked: ready as soon as it is read. Its indexes are read as 32-bit words, so move it to
+                    // an aligned address if the end of a static memory range was not aligned
+                    if ((uintptr_t)ld.ptr & 3) {
+                        uint8_t* aligned = (uint8_t*)(((uintptr_t)ld.destination + 3) & ~(uintptr_t)3);
+                        if (aligned + fsize > ld.destination + ld.allocatedSize) {
+                            Serial.println("Error: Not enough memory to align pre-baked image.");
+                            return failLoad();
+                        }
+                        memmove(aligned, ld.ptr, fsize);
+                        ld.ptr = aligned;
+                    }
+                    if (!parseBaked(ld.ptr)) return failLoad();
+                    ld.stage = STAGE_DONE;
+                    break;
+                }
+                parseHeader(ld.ptr);
+                if (!image) return failLoad();
+                rows = abs(ht);
+                used += image - ld.ptr;
+                ld.stage = STAGE_SCAN;
+                ld.done = 0;
+                ld.unusedMask = unusedAlphaMask();
+                break;
+            case STAGE_SCAN:
+                if (ld.done < rows && ld.unusedMask) {
+                    if (rowHasUnusedAlpha(ld.done, ld.unusedMask)) {
+                        alphaChannel = true;
+                        aMask = ld.unusedMask;
+                        aScale = maskToScale(aMask);
+                        aShift = maskToShift(aMask);
+                        ld.done = rows;
+                    } else {
+                        ld.done++;
+                    }
+                    used += rowBytes;
+                } else if (stream) {
+                    ld.stage = STAGE_DONE; // streamed rows are not converted or indexed
+                } else {
+                    startConversion();
+                }
+                break;
+            case STAGE_CONVERT:
+                if (ld.done < rows) {
+                    convertImage(ld.mode, ld.convertDest, ld.done, ld.done + 1);
+                    ld.done++;
+                    used += convertedSize(ld.mode) / rows;
+                } else {
+                    finishConversion(ld.mode, ld.convertDest);
+                    if (ld.converted) bmpfile = ld.converted; // release the file data
+                    ld.converted.reset();
+                    ld.stage = STAGE_SPANS;
+                    ld.done = 0;
+                }
+                break;
+            case STAGE_SPANS:
+                // Builds a table of skip / copy / blend runs for every row of an image with an alpha channel,
+                // so render() can jump over transparent pixels and write opaque pixels without blending.
+                if (!alphaChannel || format == RLE8 || format == RLE4) { // compressed data already consists of runs
+                    ld.stage = STAGE_MASK;
+                    ld.done = 0;
+                } else if (ld.done < rows) {
+                    ld.rowOffsets.push_back(ld.runs.size());
+                    addRowSpans(ld.runs, ld.done);
+                    ld.done++;
+                    used += rowBytes;
+                } else {
+                    ld.rowOffsets.push_back(ld.runs.size());
+                    finishSpanIndex(ld.runs, ld.rowOffsets);
+                    ld.stage = STAGE_MASK;
+                    ld.done = 0;
+                }
+                break;
+            case STAGE_MASK:
+                // Builds the coverage mask of an image with transparency, for hitTest() and collidesWith()
+                if (ld.done == 0 && !startMask()) {
+                    ld.stage = STAGE_DONE;
+                } else if (ld.done < rows) {
+                    addRowMask(ld.done);
+                    ld.done++;
+                    used += rowBytes;
+                } else {
+                    ld.stage = STAGE_DONE;
+                }
+                break;
+            case STAGE_DONE:
+                break;
+        }
+    } while (used < maxBytes && ld.stage != STAGE_DONE);
+
+    if (ld.stage == STAGE_DONE) {
+        loading.reset();
+        status = LOAD_READY;
     }
+    return status;
+}
+
+BitmapSprite::LoadStatus BitmapSprite::continueLoadFor(uint32_t microseconds) {
+    // Advances a load started by beginLoad() in small steps until about `microseconds` have passed.
+    // Returns LOAD_PENDING until the sprite is ready to render.
+    uint32_t start = micros();
+    LoadStatus result;
+    do {
+        result = continueLoad(LOAD_STEP_BYTES);
+    } while (result == LOAD_PENDING && micros() - start < microseconds);
+    return result;
+}
 
-    uint32_t rd = 0, gd = 0, bd = 0;
+bool BitmapSprite::loadBaked(const void* data, size_t size) {
+    // Uses a pre-baked image (see bake()) in place, without copying it: e.g. a const array in flash memory,
+    // or a file mapped into memory on the host (SD.map()). The data must be 4-byte aligned, and stay valid
+    // and unchanged while any copy of the sprite uses it. Position, alpha, blend mode and frame are kept.
+    // Returns 0 if the data is not a valid pre-baked image.
+    clearImage();
+    fsize = size;
 
+    if (((uintptr_t)data & 3) || !isBaked((const uint8_t*)data, size)) {
+        Serial.println("Error: Not an aligned pre-baked image.");
+        failLoad();
+        return 0;
+    }
 
-    if ((a > 0) && (alpha > 0)) {
+    // note: the memory is not owned by the sprite, so bmpfile stays empty
+    if (!parseBaked((uint8_t*)data)) {
+        failLoad();
+        return 0;
+    }
+    status = LOAD_READY;
+    return 1;
+}
 
-        a = a * alpha * 257 / 255; // expands 0xFF * 0xFF to 0xFFFF
+void BitmapSprite::clearImage() {
+    // helper function releases the image, keeping the sprite's placement, alpha, blend mode and frame
+    BitmapSprite empty;
+    empty.x = x;
+    empty.y = y;
+    empty.alpha = alpha;
+    empty.blend = blend;
+    empty.frame = frame;
+    empty.transformed = transformed;
+    empty.transform = transform;
+    empty.colorMap = colorMap;
+    *this = empty;
+}
 
-        if (a < 0xFFFF) {
+BitmapSprite::LoadStatus BitmapSprite::failLoad() {
+    // helper function abandons a load and leaves the sprite empty
+    loading.reset();
+    stream.reset();
+    bmpfile.reset();
+    spanIndex.reset();
+    rleIndex.reset();
+    coverMask.reset();
+    maskPending = false;
+    paletteColors.reset();
+    imageColors.reset();
+    mappedColors.reset();
+    image = nullptr;
+    wd = 0;
+    ht = 0;
+    status = LOAD_FAILED;
+    return status;
+}
 
-            r = decodeGamma8to16(r);
-            g = decodeGamma8to16(g);
-            b = decodeGamma8to16(b);
+void BitmapSprite::startConversion() {
+    // helper function finds memory for converting the image (LOAD_RGB24A, LOAD_LINEAR), and moves on
+    LoadState& ld = *loading;
+    ld.stage = STAGE_SPANS;
+    ld.done = 0;
+    if (ld.mode == LOAD_BMP) return;
 
-            rd = decodeGamma8to16((*bufPtr).red);
-            gd = decodeGamma8to16((*bufPtr).green);
-            bd = decodeGamma8to16((*bufPtr).blue);
+    if (ld.destination) {
+        uint8_t* dest = (uint8_t*)(((uintptr_t)ld.destination + 3) & ~(uintptr_t)3); // align converted rows
+        if (dest + convertedSize(ld.mode) > ld.ptr) {
+            Serial.println("Error: Not enough memory to convert image, keeping BMP data.");
+            return;
+        }
+        ld.convertDest = dest;
+    } else {
+        // convert into a new buffer, then release the file data
+        ld.converted.reset(new uint8_t[convertedSize(ld.mode)], std::default_delete<uint8_t[]>());
 
-            r = encodeGamma16to8((uint16_t)(rd + ((a * (r - rd)) >> 16)));
-            g = encodeGamma16to8((uint16_t)(gd + ((a * (g - gd)) >> 16)));
-            b = encodeGamma16to8((uint16_t)(bd + ((a * (b - bd)) >> 16)));
+        if (!ld.converted) {
+            Serial.println("Error: Failed to allocate memory for conversion.");
+            return;
         }
-        *bufPtr = rgb24(r, g, b);
+        ld.convertDest = ld.converted.get();
     }
+    ld.stage = STAGE_CONVERT;
 }
 
-void BitmapSprite::loadBitmap(const char* filename) {
+bool BitmapSprite::loadStream(const char* filename, void* cache, size_t cacheSize) {
+    // helper function keeps the file open and only the header and palette in memory
+    // pixel rows are read into the row cache as they become visible (see prepareStream)
+    // Returns 0 if the image cannot be streamed.
     File file = SD.open(filename);
 
     if (!file) {
         Serial.println("Error: Could not open file.");
         file.close();
-        return;
+        return 0;
     }
 
     fsize = file.size();
 
-    // dynamically allocate array to hold file content
-    // use shared_ptr so multiple sprites can point to the same data
-    bmpfile.reset(new uint8_t[fsize], std::default_delete<uint8_t[]>());
+    // the header, color masks and palette end where the pixel rows start
+    uint8_t fileHeader[14];
+    bool headerRead = fsize >= 14 && file.read(fileHeader, 14) == 14;
+    size_t dataOffset = headerRead ? read32(fileHeader + 10) : 0;
+
+    if (headerRead && isBaked(fileHeader, fsize)) {
+        // the sprite state is stored, not the pixel rows as in a BMP file
+        Serial.println("Error: Pre-baked images cannot be streamed, loading into memory.");
+        baked = true;
+        file.close();
+        return 0;
+    }
+
+    if (dataOffset < 14 || dataOffset > fsize) {
+        Serial.println("Error: Unsupported file format.");
+        file.close();
+        return 0;
+    }
+
+    // allocate at least the largest header plus color masks, so parseHeader stays within the buffer
+    size_t headerBytes = max(dataOffset, (size_t)(14 + 124));
+    bmpfile.reset(new uint8_t[headerBytes](), std::default_delete<uint8_t[]>());
 
     if (!bmpfile) {
         Serial.println("Error: Failed to allocate memory.");
         file.close();
-        return;
+        return 0;
     }
 
-    uint8_t* ptr = bmpfile.get();
+    memcpy(bmpfile.get(), fileHeader, 14);
+    file.read(bmpfile.get() + 14, dataOffset - 14);
 
-    file.read(ptr, fsize);
-    file.close();
+    stream.reset(new StreamCache());
+    stream->file = file;
+    if (cache) {
+        // align slots to 4 bytes, like the rows of a BMP file
+        uint8_t* slots = (uint8_t*)(((uintptr_t)cache + 3) & ~(uintptr_t)3);
+        size_t skipped = slots - (uint8_t*)cache;
+        stream->slots = slots;
+        stream->size = cacheSize > skipped ? cacheSize - skipped : 0;
+    }
 
-    // Flush cache just in case...
-    if ((uint32_t)ptr >= 0x20200000u) arm_dcache_flush_delete(ptr, fsize);
+    parseHeader(bmpfile.get());
+
+    if (wd == 0) { // unsupported format
+        stream.reset(); // closes the file
+        return 0;
+    }
 
-    parseHeader(ptr);
+    if (format == RLE8 || format == RLE4) {
+        // compressed rows have no fixed position in the file
+        Serial.println("Error: Compressed images cannot be streamed, loading into memory.");
+        stream.reset();
+        return 0;
+    }
+    return 1;
 }
 
-void BitmapSprite::loadBitmap(const char* filename, void* destination, size_t allocatedSize) {
-    File file = SD.open(filename);
+bool BitmapSprite::prepareStream(uint firstRow, uint lastRow, uint col, uint count) {
+    // helper function makes sure rows [firstRow, lastRow], columns [col, col + count) are in the row cache,
+    // plus read-ahead rows and columns in the direction the visible window moved since the last render
+    StreamCache& sc = *stream;
+    uint colAlign = (sc.bitspp < 8) ? 8 / sc.bitspp : 1; // segments start on a byte boundary
 
-    if (!file) {
-        Serial.println("Error: Could not open file.");
-        file.close();
-        return;
+    if (sc.layoutWidth != matrixWidth) {
+        // slots hold whole rows if the image is not much wider than the display, otherwise row segments
+        uint cols = matrixWidth + STREAM_AHEAD_COLS + colAlign;
+        if (cols >= wd) {
+            sc.slotCols = wd;
+            sc.slotBytes = rowBytes;
+        } else {
+            sc.slotCols = cols;
+            sc.slotBytes = ((cols * sc.bitspp + 7) / 8 + 3) & ~3;
+        }
+
+        if (!sc.slots || sc.memory) {
+            // no buffer was provided: allocate enough slots for the display height plus read-ahead
+            sc.size = (size_t)sc.slotBytes * min(abs(ht), matrixHeight + 2 * STREAM_AHEAD_ROWS);
+            sc.memory.reset(new uint8_t[sc.size], std::default_delete<uint8_t[]>());
+            sc.slots = sc.memory.get();
+            if (!sc.slots) sc.size = 0;
+        }
+
+        sc.numSlots = min(sc.size / sc.slotBytes, (size_t)abs(ht));
+        sc.slotRow.assign(sc.numSlots, -1);
+        sc.slotCol.assign(sc.numSlots, 0);
+        sc.layoutWidth = matrixWidth;
+
+        if (sc.numSlots == 0) Serial.println("Error: Not enough memory to cache a row.");
     }
+    if (sc.numSlots == 0) return 0;
 
-    fsize = file.size();
+    int dRow = (sc.lastRow >= 0) ? (int)firstRow - sc.lastRow : 0;
+    int dCol = (sc.lastCol >= 0) ? (int)col - sc.lastCol : 0;
+    sc.lastRow = firstRow;
+    sc.lastCol = col;
 
-    if (fsize > allocatedSize) {
-        Serial.println("Error: File too large.");
-        file.close();
-        return;
+    // columns to read for missing rows: the window, with the spare room on the side it moves towards
+    if (sc.slotCols == wd) {
+        sc.windowCol = 0;
+    } else {
+        int room = sc.slotCols - (colAlign - 1) - count;
+        int start = (dCol > 0) ? col : (dCol < 0) ? col - room : col - room / 2;
+        start = max(start, 0);
+        sc.windowCol = start - start % colAlign;
     }
 
-    // note: since the memory is statically allocated, do not initialize the shared_ptr.
-    bmpfile.reset();
+    // rows to cache: the visible rows, plus read-ahead rows if they fit
+    uint from = firstRow;
+    uint to = lastRow;
+    int ahead = min((int)STREAM_AHEAD_ROWS, (int)sc.numSlots - (int)(lastRow - firstRow + 1));
+    if (ahead > 0 && dRow > 0) to = min(lastRow + ahead, (uint)abs(ht) - 1);
+    if (ahead > 0 && dRow < 0) from = max((int)firstRow - ahead, 0);
+
+    for (uint row = from; row <= to;) {
+        if (streamRowCached(row, col, count)) {
+            row++;
+            continue;
+        }
+        // whole rows are adjacent in the file and, until the slots wrap around, in the cache: read them at once
+        uint rows = 1;
+        if (sc.slotCols == wd) {
+            uint slot = row % sc.numSlots;
+            while (row + rows <= to && slot + rows < sc.numSlots && !streamRowCached(row + rows, col, count)) rows++;
+        }
+        readStreamRows(row, rows, sc.windowCol);
+        row += rows;
+    }
+    return 1;
+}
 
-    uint8_t* ptr = (uint8_t*)destination;
+bool BitmapSprite::streamRowCached(uint row, uint col, uint count) {
+    // helper function checks that the row cache holds columns [col, col + count) of an image row
+    StreamCache& sc = *stream;
+    uint slot = row % sc.numSlots;
+    return sc.slotRow[slot] == (int32_t)row && sc.slotCol[slot] <= col && col + count <= sc.slotCol[slot] + sc.slotCols;
+}
 
-    file.read(ptr, fsize);
-    file.close();
+const uint8_t* BitmapSprite::streamRow(uint row, uint col, uint count, uint& segCol) {
+    // helper function returns the cached segment holding columns [col, col + count) of an image row,
+    // and the column it starts at; reads the row if it was evicted (cache smaller than the visible rows)
+    StreamCache& sc = *stream;
+    uint slot = row % sc.numSlots;
+    if (!streamRowCached(row, col, count)) readStreamRows(row, 1, sc.windowCol);
+    segCol = sc.slotCol[slot];
+    return sc.slots + slot * sc.slotBytes;
+}
+
+void BitmapSprite::readStreamRows(uint row, uint rows, uint segCol) {
+    // helper function reads consecutive rows, starting at column segCol, into consecutive slots
+    StreamCache& sc = *stream;
+    uint slot = row % sc.numSlots;
+    uint offset = segCol * sc.bitspp / 8;
+    size_t bytes = (size_t)(rows - 1) * sc.slotBytes + min(sc.slotBytes, (uint)rowBytes - offset);
+    uint8_t* ptr = sc.slots + slot * sc.slotBytes;
+
+    sc.file.seek(sc.dataOffset + row * rowBytes + offset);
+    sc.file.read(ptr, bytes);
 
     // Flush cache just in case...
-    if ((uint32_t)ptr >= 0x20200000u) arm_dcache_flush_delete(ptr, fsize);
+    if ((uintptr_t)ptr >= 0x20200000u) arm_dcache_flush_delete(ptr, bytes);
 
-    parseHeader(ptr);
+    for (uint k = 0; k < rows; k++) {
+        sc.slotRow[slot + k] = row + k;
+        sc.slotCol[slot + k] = segCol;
+    }
 }
 
-
 void BitmapSprite::parseHeader(uint8_t* ptr) {
 
     bool invalidFormat = false;
@@ -268,14 +2314,16 @@ void BitmapSprite::parseHeader(uint8_t* ptr) {
             break;
         case 4:
             format = RGB4;
-            if (!(compression == 0)) invalidFormat = true; // only uncompressed type supported
+            if (compression == 2) format = RLE4; // run-length encoded
+            else if (!(compression == 0)) invalidFormat = true; // only uncompressed and RLE4 types supported
             palette = ptr + 14 + headerSize;
             if (colorsUsed == 0) colorsUsed = 16; // 1 << bitspp
             if (14 + headerSize + colorsUsed * 4 > dataOffset) invalidFormat = true;
             break;
         case 8:
             format = RGB8;
-            if (!(compression == 0)) invalidFormat = true; // only uncompressed type supported
+            if (compression == 1) format = RLE8; // run-length encoded
+            else if (!(compression == 0)) invalidFormat = true; // only uncompressed and RLE8 types supported
             palette = ptr + 14 + headerSize;
             if (colorsUsed == 0) colorsUsed = 256; // 1 << bitspp
             if (14 + headerSize + colorsUsed * 4 > dataOffset) invalidFormat = true;
@@ -334,6 +2382,9 @@ void BitmapSprite::parseHeader(uint8_t* ptr) {
             invalidFormat = true;
     }
 
+    // compressed bitmaps are always stored bottom-to-top, and must give the size of the compressed data
+    if ((format == RLE8 || format == RLE4) && (ht < 0 || imageSize == 0)) invalidFormat = true;
+
     if (!invalidFormat && (bitspp == 16 || bitspp == 32)) {
         // check that color masks are contiguous and non-overlapping
         bool overlappingMasks = (rMask & gMask) || (rMask & bMask) || (rMask & aMask) || (gMask & bMask) || (gMask & aMask) || (bMask & aMask);
@@ -357,6 +2408,9 @@ void BitmapSprite::parseHeader(uint8_t* ptr) {
         }
     }
 
+    // decoded while colorsUsed is known; an image converted by its load mode drops it again
+    if (!invalidFormat && palette && !decodePalette(colorsUsed)) invalidFormat = true;
+
     if (invalidFormat) {
         Serial.println("Error: Unsupported file format.");
         bmpfile.reset();
@@ -365,38 +2419,529 @@ void BitmapSprite::parseHeader(uint8_t* ptr) {
         return;
     }
 
-    image = ptr + dataOffset;
+    if (stream) {
+        // streamed: pixel rows stay in the file
+        stream->dataOffset = dataOffset;
+        stream->bitspp = bitspp;
+    } else {
+        image = ptr + dataOffset;
+    }
+
+    if (format == RLE8 || format == RLE4) {
+        rleBytes = imageSize;
+        if (image) buildRLEIndex();
+    }
+}
+
+bool BitmapSprite::isBaked(const uint8_t* ptr, size_t size) {
+    // helper function checks for the signature of a pre-baked image
+    return size >= sizeof(BakedHeader) && memcmp(ptr, "BSPR", 4) == 0;
+}
+
+bool BitmapSprite::parseBaked(uint8_t* ptr) {
+    // helper function takes over a pre-baked image of fsize bytes. Its fields were validated and its indexes built
+    // when it was baked, so only the sections and the offsets in its indexes are checked to lie within the data.
+    BakedHeader hdr;
+    memcpy(&hdr, ptr, sizeof(hdr)); // the data may not be aligned for 32-bit reads (see read32)
+    uint rows = abs(hdr.height);
+    bool compressed = hdr.format == RLE8 || hdr.format == RLE4;
+    bool indexed = hdr.format == RGB1 || hdr.format == RGB4 || hdr.format == RGB8 || compressed;
+    uint bits = (hdr.format == RGB1) ? 1 : (hdr.format == RGB4 || hdr.format == RLE4) ? 4 : 8;
+
+    auto outside = [&](uint32_t offset, uint32_t bytes) {
+        return (offset & 3) || offset > fsize || bytes > fsize - offset;
+    };
+
+    bool invalidFormat = hdr.version != BAKED_VERSION || hdr.format > RLE4 || hdr.width == 0 || hdr.height == 0;
+    if (outside(hdr.paletteOffset, hdr.paletteBytes) || outside(hdr.imageOffset, hdr.imageBytes)) invalidFormat = true;
+    if (outside(hdr.spanOffset, hdr.spanBytes) || outside(hdr.rleOffset, hdr.rleBytes)) invalidFormat = true;
+    if (outside(hdr.framesOffset, hdr.frameCount * sizeof(Rect))) invalidFormat = true;
+    if (indexed && hdr.paletteBytes < (4u << bits)) invalidFormat = true;
+    if (compressed ? hdr.rleBytes != 2 * rows * sizeof(uint32_t) : hdr.imageBytes < (uint32_t)hdr.rowBytes * rows) invalidFormat = true;
+    if (!compressed && !invalidFormat) {
+        // rows must hold the whole width: bits per pixel of each Format, plus the alpha row of RGB24A
+        static const uint8_t formatBits[] = {1, 4, 8, 16, 24, 32, 32, 24, 64};
+        uint32_t pixelBits = formatBits[hdr.format] + ((hdr.format == RGB24A && (hdr.flags & BAKED_ALPHA)) ? 8 : 0);
+        if (hdr.rowBytes < (hdr.width * pixelBits + 7) / 8) invalidFormat = true;
+    }
+    if (hdr.spanBytes && !invalidFormat) {
+        const uint32_t* spans = (const uint32_t*)(ptr + hdr.spanOffset);
+        if (hdr.spanBytes < (rows + 1) * sizeof(uint32_t)) invalidFormat = true;
+        else if (((rows + 1) + (spans[rows] + 1) / 2) * sizeof(uint32_t) > hdr.spanBytes) invalidFormat = true;
+        // row offsets only grow, so every row's runs lie before spans[rows]
+        for (uint row = 0; row < rows && !invalidFormat; row++) {
+            if (spans[row] > spans[row + 1]) invalidFormat = true;
+        }
+    }
+    if (compressed && !invalidFormat) {
+        // every row starts within the RLE data, at a column within the image
+        const uint32_t* rowIndex = (const uint32_t*)(ptr + hdr.rleOffset);
+        for (uint row = 0; row < rows && !invalidFormat; row++) {
+            if (rowIndex[2 * row] > hdr.imageBytes || rowIndex[2 * row + 1] > hdr.width) invalidFormat = true;
+        }
+    }
+
+    if (invalidFormat) {
+        Serial.println("Error: Unsupported pre-baked image.");
+        return 0;
+    }
+
+    baked = true;
+    format = (Format)hdr.format;
+    wd = hdr.width;
+    ht = hdr.height;
+    rowBytes = hdr.rowBytes;
+    alphaChannel = hdr.flags & BAKED_ALPHA;
+    rMask = hdr.rMask;
+    gMask = hdr.gMask;
+    bMask = hdr.bMask;
+    aMask = hdr.aMask;
+    rScale = maskToScale(rMask);
+    gScale = maskToScale(gMask);
+    bScale = maskToScale(bMask);
+    aScale = maskToScale(aMask);
+    rShift = maskToShift(rMask);
+    gShift = maskToShift(gMask);
+    bShift = maskToShift(bMask);
+    aShift = maskToShift(aMask);
+
+    palette = indexed ? ptr + hdr.paletteOffset : nullptr;
+    image = ptr + hdr.imageOffset;
+    if (compressed) rleBytes = hdr.imageBytes;
+    if (indexed && !decodePalette(1u << bits)) return 0;
+
+    // the indexes point into the data without owning it: bmpfile, if allocated, keeps it alive
+    if (hdr.spanBytes) spanIndex = std::shared_ptr<uint32_t>(std::shared_ptr<uint32_t>(), (uint32_t*)(ptr + hdr.spanOffset));
+    if (hdr.rleBytes) rleIndex = std::shared_ptr<uint32_t>(std::shared_ptr<uint32_t>(), (uint32_t*)(ptr + hdr.rleOffset));
+    maskPending = true; // not part of the pre-baked data, and most sprites are never tested: see place()
+    if (hdr.frameCount) return setFrames((const Rect*)(ptr + hdr.framesOffset), hdr.frameCount);
+    return 1;
+}
+
+bool BitmapSprite::bake(const char* filename) {
+    // Writes the loaded image to a pre-baked image file, in its load mode and with its atlas frames.
+    // Loading a pre-baked file takes one read and no parsing, scanning, conversion or indexing,
+    // so baking images offline (see extras/bake) or on the first boot shortens start-up.
+    // Returns 0 if the image is not loaded into memory, or the file could not be written.
+    if (!image || loading) {
+        Serial.println("Error: Only images loaded into memory can be baked.");
+        return 0;
+    }
+
+    uint rows = abs(ht);
+    bool compressed = format == RLE8 || format == RLE4;
+    bool indexed = format == RGB1 || format == RGB4 || format == RGB8 || compressed;
+    uint bits = (format == RGB1) ? 1 : (format == RGB4 || format == RLE4) ? 4 : 8;
+
+    BakedHeader hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    memcpy(hdr.magic, "BSPR", 4);
+    hdr.version = BAKED_VERSION;
+    hdr.format = format;
+    hdr.flags = alphaChannel ? BAKED_ALPHA : 0;
+    hdr.width = wd;
+    hdr.height = ht;
+    hdr.rowBytes = rowBytes;
+    hdr.frameCount = frameCount();
+    hdr.rMask = rMask;
+    hdr.gMask = gMask;
+    hdr.bMask = bMask;
+    hdr.aMask = aMask;
+
+    // lay out the sections, each starting at a multiple of 4 bytes
+    uint32_t offset = sizeof(BakedHeader);
+    auto place = [&](uint32_t bytes, uint32_t& sectionOffset) {
+        sectionOffset = offset;
+        offset += (bytes + 3) & ~3u;
+    };
+    hdr.paletteBytes = indexed ? (4u << bits) : 0; // all possible indexes, so rendering never reads past the end
+    place(hdr.paletteBytes, hdr.paletteOffset);
+    hdr.imageBytes = compressed ? rleBytes : (uint32_t)rowBytes * rows;
+    place(hdr.imageBytes, hdr.imageOffset);
+    hdr.spanBytes = spanIndex ? ((rows + 1) + (spanIndex.get()[rows] + 1) / 2) * sizeof(uint32_t) : 0;
+    place(hdr.spanBytes, hdr.spanOffset);
+    hdr.rleBytes = rleIndex ? 2 * rows * sizeof(uint32_t) : 0;
+    place(hdr.rleBytes, hdr.rleOffset);
+    place(hdr.frameCount * sizeof(Rect), hdr.framesOffset);
+
+    if (SD.exists(filename)) SD.remove(filename); // FILE_WRITE appends to an existing file
+    File file = SD.open(filename, FILE_WRITE);
+
+    if (!file) {
+        Serial.println("Error: Could not create file.");
+        return 0;
+    }
+
+    // writes `bytes` of data, then zeros up to the next section
+    size_t written = 0;
+    auto put = [&](const void* data, size_t bytes, size_t sectionBytes) {
+        const uint8_t zeros[4] = {0, 0, 0, 0};
+        written += file.write(data, bytes);
+        for (size_t pad = ((sectionBytes + 3) & ~(size_t)3) - bytes; pad > 0; pad -= min(pad, sizeof(zeros))) {
+            written += file.write(zeros, min(pad, sizeof(zeros)));
+        }
+    };
+    put(&hdr, sizeof(hdr), sizeof(hdr));
+    // a BMP palette can hold fewer colors; it always ends before the pixel rows
+    if (indexed) put(palette, min((size_t)(image - palette), (size_t)hdr.paletteBytes), hdr.paletteBytes);
+    put(image, hdr.imageBytes, hdr.imageBytes);
+    if (spanIndex) put(spanIndex.get(), hdr.spanBytes, hdr.spanBytes);
+    if (rleIndex) put(rleIndex.get(), hdr.rleBytes, hdr.rleBytes);
+    if (frames) put(frames->data(), hdr.frameCount * sizeof(Rect), hdr.frameCount * sizeof(Rect));
+    file.close();
+
+    if (written != offset) {
+        Serial.println("Error: Could not write file.");
+        return 0;
+    }
+    return 1;
+}
 
+uint32_t BitmapSprite::unusedAlphaMask() {
     // Some bitmaps have alpha channel data without a valid alpha bitmask.
-    // In this case, scan the image for any nonzero alpha data in the unusued MSBs.
+    // In this case, the image is scanned for any nonzero alpha data in the unused MSBs (see continueLoad).
     // If all alpha bits are zero, the image is treated as fully opaque.
-    if ((bitspp == 16 || bitspp == 32) && alphaChannel == false) {
-        uint32_t unusedMask = (1 << bitspp) - (1 << (32 - __builtin_clz(rMask | gMask | bMask)));
-        if (unusedMask != 0) {
-            uint8_t* rowPtr = image;
-            for (int j = 0; j < abs(ht); j++) {
-                uint8_t* pixPtr = rowPtr;
-                rowPtr += rowBytes;
-                for (int i = 0; i < wd; i++) {
-                    uint32_t pixWord;
-                    if (bitspp == 16) {
-                        pixWord = read16(pixPtr);
-                        pixPtr += 2;
-                    } else {
-                        pixWord = read32(pixPtr);
-                        pixPtr += 4;
-                    }
-                    if (pixWord & unusedMask) {
-                        alphaChannel = true;
-                        break;
-                    }
+    // Returns the unused MSBs of 16 and 32 bpp images without an alpha bitmask, or 0.
+    if (alphaChannel || !(format == XRGB16 || format == ARGB32 || format == XRGB32)) return 0;
+    int bitspp = (format == XRGB16) ? 16 : 32;
+    int usedBits = 32 - __builtin_clz(rMask | gMask | bMask);
+    return (uint32_t)((1ull << bitspp) - (1ull << usedBits));
+}
+
+bool BitmapSprite::rowHasUnusedAlpha(uint row, uint32_t unusedMask) {
+    // helper function checks for nonzero bits under unusedMask in any pixel of one 16 or 32 bpp row
+    int bitspp = (format == XRGB16) ? 16 : 32;
+    uint bytesPerPixel = bitspp / 8;
+    uint8_t chunk[256];
+
+    if (stream) stream->file.seek(stream->dataOffset + row * rowBytes);
+
+    for (uint i = 0; i < wd;) {
+        uint n = wd - i;
+        const uint8_t* pixPtr;
+        if (stream) {
+            // streamed: read the row in chunks
+            n = min(n, (uint)(sizeof(chunk) / bytesPerPixel));
+            stream->file.read(chunk, n * bytesPerPixel);
+            pixPtr = chunk;
+        } else {
+            pixPtr = image + row * rowBytes + i * bytesPerPixel;
+        }
+
+        for (uint k = 0; k < n; k++) {
+            uint32_t pixWord = (bitspp == 16) ? read16(pixPtr) : read32(pixPtr);
+            if (pixWord & unusedMask) return true;
+            pixPtr += bytesPerPixel;
+        }
+        i += n;
+    }
+    return false;
+}
+
+void BitmapSprite::addRowSpans(std::vector<uint16_t>& runs, uint row) {
+    // helper function appends the skip / copy / blend runs of one image row to the span index under construction
+    switch (format) {
+        case RGB1: addSpans<RGB1>(runs, row); break;
+        case RGB4: addSpans<RGB4>(runs, row); break;
+        case RGB8: addSpans<RGB8>(runs, row); break;
+        case XRGB16: addSpans<XRGB16>(runs, row); break;
+        case RGB24: addSpans<RGB24>(runs, row); break;
+        case ARGB32: addSpans<ARGB32>(runs, row); break;
+        case XRGB32: addSpans<XRGB32>(runs, row); break;
+        case RGB24A: addSpans<RGB24A>(runs, row); break;
+        case LINEAR64: addSpans<LINEAR64>(runs, row); break;
+        case RLE8: // the compressed data already consists of runs
+        case RLE4:
+            break;
+    }
+}
+
+void BitmapSprite::finishSpanIndex(const std::vector<uint16_t>& runs, const std::vector<uint32_t>& rowOffsets) {
+    // helper function stores the span index: per-row run offsets, followed by the runs.
+    // The table is placed in dynamically allocated memory, and is shared by copies of the sprite.
+    spanIndex.reset();
+
+    // Noisy alpha makes short runs that cost more to walk than they save; keep per-pixel alpha then.
+    if (runs.size() * 4 > (size_t)wd * abs(ht)) return;
+
+    size_t words = rowOffsets.size() + (runs.size() + 1) / 2;
+    spanIndex.reset(new uint32_t[words], std::default_delete<uint32_t[]>());
+    if (!spanIndex) return;
+
+    memcpy(spanIndex.get(), rowOffsets.data(), rowOffsets.size() * sizeof(uint32_t));
+    memcpy(spanIndex.get() + rowOffsets.size(), runs.data(), runs.size() * sizeof(uint16_t));
+}
+
+void BitmapSprite::buildRLEIndex() {
+    // Records where every row of an RLE image starts in the compressed data, and at which column,
+    // so render() can begin at any clipped row. Rows skipped by delta or end of bitmap escapes are empty.
+    // Pixels not covered by any run are transparent: alphaChannel is set if there are such pixels.
+    uint rows = abs(ht);
+    rleIndex.reset(new uint32_t[2 * rows], std::default_delete<uint32_t[]>());
+
+    if (!rleIndex) {
+        Serial.println("Error: Failed to allocate memory.");
+        image = nullptr;
+        return;
+    }
+
+    uint32_t* rowIndex = rleIndex.get();
+    const uint8_t* ptr = image;
+    const uint8_t* end = image + rleBytes;
+    uint row = 0;
+    uint x = 0;
+    bool gaps = false;
+    rowIndex[0] = 0;
+    rowIndex[1] = 0;
+
+    while (row < rows && ptr + 2 <= end) {
+        uint n = ptr[0];
+        uint c = ptr[1];
+        ptr += 2;
+        uint nextRow = row;
+        uint nextX = x;
+
+        if (n > 0) { // encoded run
+            x += n;
+            continue;
+        } else if (c == 0) { // end of line
+            nextRow = row + 1;
+            nextX = 0;
+        } else if (c == 1) { // end of bitmap
+            break;
+        } else if (c == 2) { // delta
+            if (ptr + 2 > end) break;
+            nextRow = row + ptr[1];
+            nextX = x + ptr[0];
+            ptr += 2;
+            if (nextRow == row) {
+                if (nextX > x) gaps = true;
+                x = nextX;
+                continue;
+            }
+        } else { // literal run, padded to 16 bits
+            uint bytes = (format == RLE8) ? c : (c + 1) / 2;
+            ptr += (bytes + 1) & ~1;
+            x += c;
+            continue;
+        }
+
+        // the row ended: rows jumped over are empty, the next row starts here
+        if (x < wd) gaps = true;
+        for (row++; row < nextRow && row < rows; row++) {
+            rowIndex[2 * row] = ptr - image;
+            rowIndex[2 * row + 1] = wd;
+            gaps = true;
+        }
+        if (row < rows) {
+            rowIndex[2 * row] = min(ptr, end) - image;
+            rowIndex[2 * row + 1] = nextX;
+            if (nextX > 0) gaps = true;
+        }
+        x = nextX;
+    }
+
+    // rows after the end of the data are empty
+    if (row < rows && x < wd) gaps = true;
+    for (row++; row < rows; row++) {
+        rowIndex[2 * row] = rleBytes;
+        rowIndex[2 * row + 1] = wd;
+        gaps = true;
+    }
+
+    if (gaps) alphaChannel = true;
+}
+
+bool BitmapSprite::startMask() {
+    // helper function allocates a cleared coverage mask, if the image has transparent pixels.
+    // Returns 0 if no mask is needed, or there is no memory for it: every pixel then counts as covered.
+    coverMask.reset();
+    if (!alphaChannel || !image) return 0;
+
+    uint rows = abs(ht);
+    maskWords = (wd + 31) / 32;
+    coverMask.reset(new uint32_t[maskWords * rows](), std::default_delete<uint32_t[]>());
+    return (bool)coverMask;
+}
+
+void BitmapSprite::addRowMask(uint row) {
+    // helper function sets the coverage bits of one image row
+    switch (format) {
+        case RGB1: addMask<RGB1>(row); break;
+        case RGB4: addMask<RGB4>(row); break;
+        case RGB8: addMask<RGB8>(row); break;
+        case XRGB16: addMask<XRGB16>(row); break;
+        case RGB24: addMask<RGB24>(row); break;
+        case ARGB32: addMask<ARGB32>(row); break;
+        case XRGB32: addMask<XRGB32>(row); break;
+        case RGB24A: addMask<RGB24A>(row); break;
+        case LINEAR64: addMask<LINEAR64>(row); break;
+        case RLE8: addMask<RLE8>(row); break;
+        case RLE4: addMask<RLE4>(row); break;
+    }
+}
+
+template <BitmapSprite::Format F>
+void BitmapSprite::addMask(uint row) {
+    // helper function marks the pixels of one row that are not fully transparent
+    uint32_t* rowMask = coverMask.get() + row * maskWords;
+
+    if (F == RLE8 || F == RLE4) { // pixels covered by runs
+        walkRLE<F>(row, wd, [&](uint start, uint length, const uint8_t*, bool) {
+            for (uint i = start; i < start + length; i++) rowMask[i >> 5] |= 0x80000000u >> (i & 31);
+        });
+        return;
+    }
+
+    RowReader rd;
+    seekPixel<F>(rd, image + row * rowBytes, 0);
+    for (int i = 0; i < wd; i++) {
+        uint32_t r, g, b, a;
+        readPixel<F, true>(rd, r, g, b, a);
+        if (a != 0) rowMask[i >> 5] |= 0x80000000u >> (i & 31);
+    }
+}
+
+void BitmapSprite::buildMask() {
+    // helper function builds the whole coverage mask at once
+    if (!startMask()) return;
+    for (uint row = 0; row < (uint)abs(ht); row++) addRowMask(row);
+}
+
+template <BitmapSprite::Format F>
+void BitmapSprite::convertRLE(LoadMode mode, uint8_t* dest, uint firstRow, uint lastRow) {
+    // helper function expands the runs of rows [firstRow, lastRow) of an RLE image to dest in the converted format
+    // pixels not covered by a run stay zero, i.e. transparent
+    size_t destRowBytes = convertedSize(mode) / abs(ht);
+
+    for (uint j = firstRow; j < lastRow; j++) {
+        uint8_t* destRow = dest + j * destRowBytes;
+        memset(destRow, 0, destRowBytes);
+
+        walkRLE<F>(j, wd, [&](uint start, uint length, const uint8_t* src, bool fill) {
+            for (uint i = 0; i < length; i++) {
+                const PaletteColor& c = paletteColors.get()[rlePaletteIndex(src, i, fill, F == RLE4)];
+                uint x = start + i;
+                if (mode == LOAD_LINEAR) {
+                    uint16_t* linPtr = (uint16_t*)(destRow + x * 8);
+                    linPtr[0] = c.linearRed;
+                    linPtr[1] = c.linearGreen;
+                    linPtr[2] = c.linearBlue;
+                    linPtr[3] = 0xFFFF;
+                } else {
+                    destRow[x * 3] = c.red;
+                    destRow[x * 3 + 1] = c.green;
+                    destRow[x * 3 + 2] = c.blue;
+                    if (alphaChannel) destRow[wd * 3 + x] = 255;
                 }
-                if (alphaChannel == true) break;
             }
-            if (alphaChannel == true) {
-                aMask = unusedMask;
-                aScale = maskToScale(aMask);
-                aShift = maskToShift(aMask);
+        });
+    }
+}
+
+template <BitmapSprite::Format F>
+void BitmapSprite::addSpans(std::vector<uint16_t>& runs, uint row) {
+    // helper function classifies the pixels of one row and appends its runs
+    // each run is a 16-bit word: type in the top 2 bits, length in the low 14 bits
+    RowReader rd;
+    seekPixel<F>(rd, image + row * rowBytes, 0);
+
+    const uint32_t opaque = (F == LINEAR64) ? 0xFFFF : 255;
+    uint runType = SPAN_SKIP;
+    uint runLength = 0;
+
+    for (int i = 0; i <= wd; i++) {
+        uint pixType = SPAN_SKIP;
+        if (i < wd) {
+            uint32_t r, g, b, a;
+            readPixel<F, true>(rd, r, g, b, a);
+            pixType = (a == 0) ? SPAN_SKIP : (a == opaque) ? SPAN_COPY : SPAN_BLEND;
+        }
+        if ((i == wd || pixType != runType || runLength == SPAN_LENGTH_MASK) && runLength > 0) {
+            runs.push_back((runType << 14) | runLength);
+            runLength = 0;
+        }
+        runType = pixType;
+        runLength++;
+    }
+}
+
+size_t BitmapSprite::convertedSize(LoadMode mode) {
+    // Calculate memory needed to hold the image in a converted format.
+    // Rows are padded to a multiple of 4 bytes.
+    size_t convertedRowBytes;
+    if (mode == LOAD_LINEAR) {
+        convertedRowBytes = wd * 8;
+    } else {
+        convertedRowBytes = (wd * (alphaChannel ? 4 : 3) + 3) & ~3;
+    }
+    return convertedRowBytes * abs(ht);
+}
+
+void BitmapSprite::convertImage(LoadMode mode, uint8_t* dest, uint firstRow, uint lastRow) {
+    // Decodes every pixel of rows [firstRow, lastRow) once into a render-ready format, so that render() only
+    // performs the blend. Rows keep the order of the BMP file, so sprite placement is unchanged.
+    switch (format) {
+        case RGB1: convertRows<RGB1>(mode, dest, firstRow, lastRow); break;
+        case RGB4: convertRows<RGB4>(mode, dest, firstRow, lastRow); break;
+        case RGB8: convertRows<RGB8>(mode, dest, firstRow, lastRow); break;
+        case XRGB16: convertRows<XRGB16>(mode, dest, firstRow, lastRow); break;
+        case RGB24: convertRows<RGB24>(mode, dest, firstRow, lastRow); break;
+        case ARGB32: convertRows<ARGB32>(mode, dest, firstRow, lastRow); break;
+        case XRGB32: convertRows<XRGB32>(mode, dest, firstRow, lastRow); break;
+        case RLE8: convertRLE<RLE8>(mode, dest, firstRow, lastRow); break;
+        case RLE4: convertRLE<RLE4>(mode, dest, firstRow, lastRow); break;
+        case RGB24A: // already converted
+        case LINEAR64:
+            break;
+    }
+}
+
+void BitmapSprite::finishConversion(LoadMode mode, uint8_t* dest) {
+    // Switches the sprite to the converted image, once all rows are converted.
+    if (format == RGB24A || format == LINEAR64) return; // already converted
+
+    format = (mode == LOAD_LINEAR) ? LINEAR64 : RGB24A;
+    rowBytes = convertedSize(mode) / abs(ht);
+    image = dest;
+    palette = nullptr;
+    paletteColors.reset();
+    imageColors.reset();
+    mappedColors.reset();
+    rleIndex.reset();
+}
+
+template <BitmapSprite::Format F>
+void BitmapSprite::convertRows(LoadMode mode, uint8_t* dest, uint firstRow, uint lastRow) {
+    // helper function writes rows [firstRow, lastRow) of the image to dest in the converted format
+    size_t destRowBytes = convertedSize(mode) / abs(ht);
+
+    for (uint j = firstRow; j < lastRow; j++) {
+        RowReader rd;
+        seekPixel<F>(rd, image + j * rowBytes, 0);
+        uint8_t* destPtr = dest + j * destRowBytes;
+        uint8_t* alphaPtr = destPtr + wd * 3;
+
+        for (int i = 0; i < wd; i++) {
+            uint32_t r, g, b, a;
+            if (alphaChannel) {
+                readPixel<F, true>(rd, r, g, b, a);
+            } else {
+                readPixel<F, false>(rd, r, g, b, a);
+            }
+
+            if (mode == LOAD_LINEAR) {
+                uint16_t* linPtr = (uint16_t*)destPtr;
+                linPtr[0] = decodeGamma8to16(r);
+                linPtr[1] = decodeGamma8to16(g);
+                linPtr[2] = decodeGamma8to16(b);
+                linPtr[3] = a * 257;
+                destPtr += 8;
+            } else {
+                *destPtr++ = r;
+                *destPtr++ = g;
+                *destPtr++ = b;
+                if (alphaChannel) *alphaPtr++ = a;
             }
         }
     }
@@ -440,14 +2985,28 @@ uint8_t BitmapSprite::maskToShift(uint32_t mask) {
     return shift;
 }
 
-uint32_t BitmapSprite::read32(uint8_t* ptr) {
+uint32_t BitmapSprite::read32(const uint8_t* ptr) {
     // helper function reads 4 bytes into 32-bit little endian int
     // without using un-aligned memory reads (can cause bug on Teensy 3.6)
     return ptr[0] | (ptr[1] << 8) | (ptr[2] << 16) | (ptr[3] << 24);
 }
 
-uint16_t BitmapSprite::read16(uint8_t* ptr) {
+uint16_t BitmapSprite::read16(const uint8_t* ptr) {
     // helper function reads 2 bytes into 16-bit little endian int
     // without using un-aligned memory reads (can cause bug on Teensy 3.6)
     return ptr[0] | (ptr[1] << 8);
 }
+
+// render() is compiled for each drawing buffer pixel type; renderClipped() is used by SpriteBatch
+template bool BitmapSprite::render<rgb16>(rgb16* buffer);
+template bool BitmapSprite::render<rgb24>(rgb24* buffer);
+template bool BitmapSprite::render<rgb48>(rgb48* buffer);
+template bool BitmapSprite::render<linear48>(linear48* buffer);
+template bool BitmapSprite::render<rgb16>(rgb16* buffer, const Rect& clip);
+template bool BitmapSprite::render<rgb24>(rgb24* buffer, const Rect& clip);
+template bool BitmapSprite::render<rgb48>(rgb48* buffer, const Rect& clip);
+template bool BitmapSprite::render<linear48>(linear48* buffer, const Rect& clip);
+template bool BitmapSprite::renderClipped<rgb16>(rgb16* buffer, const Rect& rect, const Rect& clip);
+template bool BitmapSprite::renderClipped<rgb24>(rgb24* buffer, const Rect& rect, const Rect& clip);
+template bool BitmapSprite::renderClipped<rgb48>(rgb48* buffer, const Rect& rect, const Rect& clip);
+template bool BitmapSprite::renderClipped<linear48>(linear48* buffer, const Rect& rect, const Rect& clip);
@@ -2,32 +2,168 @@
     BitmapSprite Class for use with SmartMatrix Library.
 
     Sprites are 2D images with transparency that can be rendered at any position on the display.
-    Image data is loaded from BMP files on the SD Card.
+    Image data is loaded from BMP files on the SD Card, or from pre-baked images (see bake()).
 */
 
 #ifndef BitmapSprite_h
 #define BitmapSprite_h
 
 #include <Arduino.h>
+#include <SD.h>
 #include <MatrixCommon.h> // from SmartMatrix library
 
 #include <memory>
+#include <vector>
+
+// Uncomment to count the pixels and time spent by rendering (see printStats); the host build sets it with
+// -DBITMAPSPRITE_STATS=ON instead. Without it, the counters are compiled out of the kernels.
+// #define BITMAPSPRITE_STATS
+
+// Drawing buffer pixel holding 16-bit linear light per channel (see LinearBuffer).
+// Sprites blend into it without gamma table lookups on the buffer side.
+typedef struct linear48 {
+    linear48() : linear48(0, 0, 0) {}
+    linear48(uint16_t r, uint16_t g, uint16_t b) {
+        red = r; green = g; blue = b;
+    }
+
+    uint16_t red;
+    uint16_t green;
+    uint16_t blue;
+} linear48;
 
 class BitmapSprite {
+    friend class SpriteBatch;
+    friend class AssetCache;
+    friend class LinearBuffer;
+    friend class BitmapFont;
+
     public:
+        enum LoadMode { // How image data is kept in memory after loading
+          LOAD_BMP, // keep the BMP file as-is: smallest, pixels are decoded on every render
+          LOAD_RGB24A, // convert to rgb24 rows plus an alpha row: up to 4 bytes per pixel
+          LOAD_LINEAR, // convert to 16-bit linear RGBA: 8 bytes per pixel, render only blends
+          LOAD_STREAM // keep only the header and palette, and read visible rows from the SD card into a row cache
+        };
+
+        enum BlendMode { // How the sprite's pixels are combined with the drawing buffer, in linear light
+          BLEND_OVER, // source-over: the sprite covers the buffer by its alpha
+          BLEND_ADD, // adds the sprite to the buffer, for glows, lights and particles
+          BLEND_MULTIPLY, // multiplies the buffer by the sprite, for shadows and color filters
+          BLEND_SCREEN, // inverse multiply: brightens like ADD, without going past white
+          BLEND_REPLACE // writes the sprite's pixels ignoring their alpha, faded by the sprite alpha
+        };
+
+        enum LoadStatus { // Progress of loading an image
+          LOAD_EMPTY, // nothing loaded
+          LOAD_PENDING, // started by beginLoad(), call continueLoad() until the load is finished
+          LOAD_READY, // ready to render
+          LOAD_FAILED // the file could not be loaded
+        };
+
+        struct Rect { // Screen rectangle, edges inclusive
+            int left;
+            int top;
+            int right;
+            int bottom;
+        };
+
+        struct Transform { // Sub-pixel placement, scaling and rotation, used while `transformed` is set
+            int32_t x = 0; // screen position of the image (or frame) center, 16.16 fixed point
+            int32_t y = 0;
+            int32_t scaleX = 0x10000; // 16.16 fixed point: 0x10000 draws 1:1, negative values mirror
+            int32_t scaleY = 0x10000;
+            uint16_t angle = 0; // clockwise rotation, 65536 steps per turn
+            bool bilinear = false; // interpolate between image pixels instead of picking the nearest
+        };
+
+        struct ColorTransform { // Color matrix applied to the sprite's pixels before blending (see setColorTransform)
+            // Each channel becomes (matrix row . (red, green, blue) + 128) / 256 + offset, computed on 8-bit sRGB
+            // values and clamped to 0..255. The matrix is 8.8 fixed point: 256 keeps a channel as it is.
+            int16_t matrix[3][3] = {{256, 0, 0}, {0, 256, 0}, {0, 0, 256}};
+            int16_t offset[3] = {0, 0, 0};
+
+            static ColorTransform tint(uint8_t red, uint8_t green, uint8_t blue); // multiplies each channel by color / 255
+            static ColorTransform brightness(int16_t scale, int16_t add = 0); // multiplies by scale / 256, then adds
+            static ColorTransform saturation(int16_t amount); // 0 is grey, 256 unchanged, above 256 more saturated
+            ColorTransform then(const ColorTransform& next) const; // this transform followed by next, unclamped in between
+        };
+
+#if defined(BITMAPSPRITE_STATS)
+        static const uint8_t FORMAT_COUNT = 11; // image formats, see formatName()
+
+        struct RenderCounters { // Work done by rendering (BITMAPSPRITE_STATS)
+            uint64_t calls = 0; // render() calls, and frames with the sprite in a SpriteBatch
+            uint64_t pixels = 0; // visited: on the display and within the clip rectangle
+            uint64_t skipped = 0; // visited but transparent
+            uint64_t copied = 0; // written without blending
+            uint64_t blended = 0;
+            uint64_t clipped = 0; // off the display or outside the clip rectangle
+            uint64_t ticks = 0; // time spent: CPU cycles on the Teensy, nanoseconds on the host
+
+            RenderCounters& operator+=(const RenderCounters& other);
+            void print(const char* label) const;
+        };
+
+        struct RenderStats { // work done by all sprites since resetStats(), e.g. in one frame
+            RenderCounters total;
+            RenderCounters formats[FORMAT_COUNT]; // by image format
+        };
+
+        static RenderStats stats();
+        static void resetStats();
+        static void printStats();
+        static const char* formatName(uint8_t format);
+#endif
+
         static void setDisplaySize(uint16_t displayWidth, uint16_t displayHeight);
 
         int x = 0;
         int y = 0;
         uint8_t alpha = 255;
+        BlendMode blend = BLEND_OVER;
+        uint16_t frame = 0; // atlas frame to render, if frames are set
+        bool transformed = false; // place the sprite with `transform` instead of x and y
+        Transform transform;
+#if defined(BITMAPSPRITE_STATS)
+        RenderCounters counters; // renders of this sprite since it was loaded; reset it at will
+#endif
 
         BitmapSprite();
-        BitmapSprite(const char* filename);
-        BitmapSprite(const char* filename, void* destination, size_t allocatedSize);
+        BitmapSprite(const char* filename, LoadMode mode = LOAD_BMP);
+        BitmapSprite(const char* filename, void* destination, size_t allocatedSize, LoadMode mode = LOAD_BMP);
+
+        bool beginLoad(const char* filename, LoadMode mode = LOAD_BMP);
+        bool beginLoad(const char* filename, void* destination, size_t allocatedSize, LoadMode mode = LOAD_BMP);
+        LoadStatus continueLoad(size_t maxBytes);
+        LoadStatus continueLoadFor(uint32_t microseconds);
+        LoadStatus loadStatus() { return status; };
+        bool loadBaked(const void* data, size_t size);
+        bool bake(const char* filename);
+
+        // the drawing buffer holds rgb16, rgb24, rgb48 or linear48 pixels, e.g. the SmartMatrix layer's backBuffer()
+        template <typename P>
+        bool render(P* buffer);
+        template <typename P>
+        bool render(P* buffer, const Rect& clip);
+        Rect bounds();
+        uint16_t width();
+        uint16_t height();
+
+        bool setFrameGrid(uint16_t frameWidth, uint16_t frameHeight, uint16_t count = 0);
+        bool setFrames(const Rect* rects, uint16_t count);
+        uint16_t frameCount() { return frames ? frames->size() : 0; };
+
+        bool setPalette(const rgb24* colors, uint16_t count, uint16_t first = 0);
+        void resetPalette();
 
-        bool render(rgb24* buffer);
-        uint16_t width() { return wd; };
-        uint16_t height() { return abs(ht); };
+        bool setColorTransform(const ColorTransform& transform);
+        void resetColorTransform();
+
+        bool hitTest(int screenX, int screenY);
+        bool collidesWith(BitmapSprite& other);
+
+        size_t memoryUsed();
 
     private:
         enum Format { // Supported BMP formats
@@ -37,7 +173,18 @@ class BitmapSprite {
           XRGB16, // 16bpp, arbitrary bitmask with transparency
           RGB24, // 24bpp, R8G8B8
           ARGB32, // 32bpp, R8G8B8 or A8R8G8B8
-          XRGB32 // 32bpp, arbitrary bitmask with transparency
+          XRGB32, // 32bpp, arbitrary bitmask with transparency
+          RGB24A, // converted: rgb24 row, followed by an alpha row if alphaChannel
+          LINEAR64, // converted: 16-bit linear R, G, B, A per pixel
+          RLE8, // 8bpp, indexed, run-length encoded
+          RLE4 // 4bpp, indexed, run-length encoded
+        };
+
+        struct RowReader { // running position within one image row
+            const uint8_t* pixPtr;
+            const uint8_t* alphaPtr; // RGB24A: current alpha byte
+            uint8_t bitMask; // RGB1: mask of the current bit
+            bool lowNibble; // RGB4: current pixel is in the low nibble
         };
         
         static uint16_t matrixWidth;
@@ -45,14 +192,45 @@ class BitmapSprite {
 
         uint16_t wd = 0;
         int16_t ht = 0;
-        uint fsize;
+        uint fsize = 0;
         std::shared_ptr<uint8_t> bmpfile;
         uint8_t* image = nullptr;
+        bool baked = false; // loaded from a pre-baked image: the indexes point into its data
+
+        // atlas frames, in image pixels counted from the top left as displayed
+        std::shared_ptr<std::vector<Rect>> frames;
 
-        BitmapSprite::Format format;
+        BitmapSprite::Format format = RGB24;
         uint8_t* palette = nullptr;
         bool alphaChannel = false;
         uint16_t rowBytes = 0;
+
+        struct PaletteColor { // palette entry of an indexed image, decoded once
+            uint8_t red; // sRGB, written as-is for opaque pixels
+            uint8_t green;
+            uint8_t blue;
+            uint16_t linearRed; // 16-bit linear, for blending
+            uint16_t linearGreen;
+            uint16_t linearBlue;
+        };
+
+        // indexed and RLE images: colors in use, one per possible index (see setPalette).
+        // Copies of the sprite share them until one of them is recolored.
+        std::shared_ptr<PaletteColor> paletteColors;
+        std::shared_ptr<PaletteColor> imageColors; // the image's own palette, decoded once per load
+        uint32_t colorChanges = 0; // counts palette and color transform changes, for SpriteBatch::renderDirty
+
+        struct ColorMap { // color transform prepared for the kernels, shared by copies of the sprite
+            ColorTransform transform;
+            bool diagonal; // channels are only scaled and offset: looked up in table
+            uint8_t table[3][256];
+        };
+
+        std::shared_ptr<const ColorMap> colorMap; // set by setColorTransform()
+        // indexed and RLE images with a color transform: paletteColors passed through it, so the kernels draw
+        // mapped colors at no cost per pixel. Shared by copies until one of them is recolored.
+        std::shared_ptr<PaletteColor> mappedColors;
+
         uint32_t rMask = 0;
         uint8_t rScale = 0;
         uint8_t rShift = 0;
@@ -66,12 +244,288 @@ class BitmapSprite {
         uint8_t aScale = 0; 
         uint8_t aShift = 0;
 
-        void composite(rgb24* bufPtr, uint row, uint col);
-        void loadBitmap(const char* filename);
-        void loadBitmap(const char* filename, void* destination, size_t allocatedSize);
+        enum SpanType { // Run types in the span index
+          SPAN_SKIP, // fully transparent
+          SPAN_COPY, // fully opaque
+          SPAN_BLEND // partially transparent
+        };
+        static const uint16_t SPAN_LENGTH_MASK = 0x3FFF;
+
+        // per-row run offsets, followed by the runs (see finishSpanIndex)
+        std::shared_ptr<uint32_t> spanIndex;
+
+        // RLE images: byte offset and first column of every row in the compressed data (see buildRLEIndex)
+        std::shared_ptr<uint32_t> rleIndex;
+        uint32_t rleBytes = 0;
+
+        // images with transparency: one bit per pixel, set where alpha is not 0, for hitTest() and collidesWith().
+        // Rows are stored like the image rows, maskWords 32-bit words each, leftmost pixel in the top bit.
+        // Without a mask, every pixel counts as covered.
+        std::shared_ptr<uint32_t> coverMask;
+        uint16_t maskWords = 0;
+        bool maskPending = false; // pre-baked images: the mask is built on the first hitTest() or collidesWith()
+
+        struct StreamCache { // open file and row cache of a LOAD_STREAM sprite
+            File file;
+            uint32_t dataOffset = 0; // file position of the pixel rows
+            uint8_t bitspp = 0;
+            std::shared_ptr<uint8_t> memory; // allocated cache memory, if no buffer was provided
+            uint8_t* slots = nullptr;
+            size_t size = 0; // bytes of cache memory
+            uint16_t layoutWidth = 0; // display width the slots are laid out for
+            uint slotBytes = 0; // each slot holds one row segment
+            uint slotCols = 0;
+            uint numSlots = 0;
+            std::vector<int32_t> slotRow; // image row held by each slot (rows are direct-mapped), -1 if none
+            std::vector<uint16_t> slotCol; // first column held by each slot
+            uint16_t windowCol = 0; // first column to read for rows of the current render
+            int lastRow = -1; // first visible row and column of the previous render, for read-ahead
+            int lastCol = -1;
+
+            ~StreamCache() { file.close(); }
+        };
+        static const uint8_t STREAM_AHEAD_ROWS = 8; // rows read ahead in the vertical scroll direction
+        static const uint8_t STREAM_AHEAD_COLS = 32; // columns read ahead in the horizontal scroll direction
+
+        // shared by copies of the sprite, like the image data
+        std::shared_ptr<StreamCache> stream;
+
+        enum LoadStage { // Steps of a load, each done a little at a time by continueLoad()
+          STAGE_READ, // read the file
+          STAGE_PARSE, // parse the header
+          STAGE_SCAN, // look for alpha data in unused bits, one row at a time
+          STAGE_CONVERT, // convert to the render-ready format (LOAD_RGB24A, LOAD_LINEAR), one row at a time
+          STAGE_SPANS, // build the span index, one row at a time
+          STAGE_MASK, // build the coverage mask, one row at a time
+          STAGE_DONE
+        };
+
+        struct LoadState { // state of a load started by beginLoad()
+            File file;
+            LoadMode mode;
+            LoadStage stage = STAGE_READ;
+            size_t done = 0; // bytes read, or rows processed, in the current stage
+            uint8_t* ptr = nullptr; // where the file is read to
+            uint8_t* destination = nullptr; // statically allocated memory range, if provided
+            size_t allocatedSize = 0;
+            uint32_t unusedMask = 0; // STAGE_SCAN: bits to check for alpha data
+            std::shared_ptr<uint8_t> converted; // STAGE_CONVERT: dynamically allocated destination
+            uint8_t* convertDest = nullptr;
+            std::vector<uint16_t> runs; // STAGE_SPANS: span index under construction
+            std::vector<uint32_t> rowOffsets;
+
+            ~LoadState() { file.close(); }
+        };
+        static const uint16_t LOAD_STEP_BYTES = 2048; // work done per continueLoad() call by continueLoadFor()
+
+        // Pre-baked image (written by bake()): this header, followed by the sections it points to, each starting
+        // at a multiple of 4 bytes. The sections hold the sprite state as it is after loading, so nothing needs
+        // to be parsed, scanned, converted or indexed again. Little-endian, like the Teensy and most hosts.
+        struct BakedHeader {
+            char magic[4]; // "BSPR"
+            uint16_t version;
+            uint8_t format; // Format of the image section
+            uint8_t flags; // BAKED_ALPHA
+            uint16_t width;
+            int16_t height; // negative if the rows are stored top-to-bottom, like in BMP files
+            uint16_t rowBytes;
+            uint16_t frameCount;
+            uint32_t rMask; // XRGB16, ARGB32, XRGB32 color masks
+            uint32_t gMask;
+            uint32_t bMask;
+            uint32_t aMask;
+            uint32_t paletteOffset; // indexed formats: 4 bytes per color, for every possible index
+            uint32_t paletteBytes;
+            uint32_t imageOffset; // pixel rows, or RLE data
+            uint32_t imageBytes;
+            uint32_t spanOffset; // span index, if any (see finishSpanIndex)
+            uint32_t spanBytes;
+            uint32_t rleOffset; // RLE row index (see buildRLEIndex)
+            uint32_t rleBytes;
+            uint32_t framesOffset; // atlas frames: left, top, right, bottom as int32 each
+        };
+        static const uint16_t BAKED_VERSION = 1;
+        static const uint8_t BAKED_ALPHA = 1;
+
+        struct CopyMark { // set on every copy of a sprite, cleared by beginLoad(): only the original continues a load
+            bool copied = false;
+            CopyMark() = default;
+            CopyMark(const CopyMark&) : copied(true) {}
+            CopyMark(CopyMark&&) = default;
+            CopyMark& operator=(const CopyMark&) { copied = true; return *this; }
+            CopyMark& operator=(CopyMark&&) = default;
+        };
+
+        std::shared_ptr<LoadState> loading;
+        CopyMark loadCopy;
+        LoadStatus status = LOAD_EMPTY;
+
+        // Rows of palette indices: a color map is applied to the palette once (see mapPalette), so the kernels
+        // and decoders of these formats are never color mapped, and the indices carry no alpha.
+        static constexpr bool indexedRows(Format format) { return format == RGB1 || format == RGB4 || format == RGB8; }
+
+        template <typename P>
+        using RowKernel = void (BitmapSprite::*)(P* bufPtr, const uint8_t* rowPtr, uint col, uint count);
+
+        template <typename P, Format F, bool pixelAlpha, bool spriteAlpha, bool colorMapped>
+        void compositeRow(P* bufPtr, const uint8_t* rowPtr, uint col, uint count);
+        template <typename P>
+        bool renderClipped(P* buffer, const Rect& rect, const Rect& clip);
+        template <typename P>
+        bool renderVisible(P* buffer, const Rect& rect, const Rect& clip);
+#if defined(BITMAPSPRITE_STATS)
+        void countCall(const Rect& rect, const Rect& clip);
+        void addStats(const RenderCounters& call);
+#endif
+        Rect source();
+        template <typename P, Format F>
+        RowKernel<P> kernelFor(bool pixelAlpha, bool spriteAlpha);
+        template <typename P, Format F, bool colorMapped>
+        RowKernel<P> alphaKernelFor(bool pixelAlpha, bool spriteAlpha);
+        template <typename P>
+        RowKernel<P> selectKernel(bool pixelAlpha, bool spriteAlpha);
+        void prepareFade(const Rect& rect);
+        template <typename RunFn>
+        void walkSpans(uint row, uint col, uint count, RunFn fn);
+        template <typename P>
+        void renderSpans(P* bufPtr, uint row, uint col, uint count, RowKernel<P> copyKernel, RowKernel<P> blendKernel);
+        template <typename P, Format F>
+        void renderRLERow(P* bufPtr, uint row, uint col, uint count, uint8_t spriteAlpha);
+
+        struct LinearPixel { // decoded pixel for the blend modes: 16-bit linear color premultiplied by alpha
+            uint16_t red;
+            uint16_t green;
+            uint16_t blue;
+            uint16_t alpha;
+        };
+        static const uint8_t MODE_CHUNK = 64; // pixels decoded at a time for the blend modes
+
+        using RowDecoder = void (BitmapSprite::*)(LinearPixel* out, const uint8_t* rowPtr, uint col, uint count, uint32_t spriteA);
+        template <typename P>
+        using ModeBlender = void (*)(P* bufPtr, const LinearPixel* src, uint count);
+
+        template <typename P>
+        bool renderBlendMode(P* bufRowPtr, int startY, int endY, int rowOrigin, int rowStep, uint col, uint count);
+        RowDecoder selectDecoder(bool pixelAlpha);
+        template <Format F>
+        RowDecoder decoderFor(bool pixelAlpha);
+        template <Format F, bool pixelAlpha, bool colorMapped>
+        void decodeRow(LinearPixel* out, const uint8_t* rowPtr, uint col, uint count, uint32_t spriteA);
+        template <typename P, Format F>
+        void renderRLEBlend(P* bufPtr, uint row, uint col, uint count, ModeBlender<P> blender);
+        template <typename P>
+        ModeBlender<P> selectBlender();
+        template <typename P, BlendMode M>
+        static void blendModeRow(P* bufPtr, const LinearPixel* src, uint count);
+        static void storeLinear(LinearPixel& p, uint32_t r, uint32_t g, uint32_t b, uint32_t a);
+
+        struct AffineMap { // maps screen pixels to image coordinates (16.16 fixed point) for transformed sprites
+            int32_t a; // image u, v per screen step in x
+            int32_t c;
+            int32_t b; // image u, v per screen step in y
+            int32_t d;
+            int rowBase; // image row of frame row 0, and the step per frame row
+            int rowStep;
+            int colBase; // image column of frame column 0
+            int32_t width; // frame size
+            int32_t height;
+        };
+
+        template <typename P>
+        using AffineKernel = void (BitmapSprite::*)(P* bufPtr, int32_t u, int32_t v, uint count, const AffineMap& map);
+        using AffineDecoder = void (BitmapSprite::*)(LinearPixel* out, int32_t u, int32_t v, uint count, const AffineMap& map, uint32_t spriteA, bool pixelAlpha);
+
+        bool affineMap(AffineMap& map);
+        Rect transformedBounds();
+        template <typename P>
+        bool renderAffine(P* buffer, const Rect& rect, const Rect& clip);
+        template <typename P>
+        AffineKernel<P> selectAffineKernel(bool bilinear);
+        template <typename P, Format F>
+        AffineKernel<P> affineKernelFor(bool bilinear);
+        template <typename P, Format F, bool colorMapped>
+        AffineKernel<P> samplingKernelFor(bool bilinear);
+        template <typename P, Format F, bool colorMapped>
+        void affineRowNearest(P* bufPtr, int32_t u, int32_t v, uint count, const AffineMap& map);
+        template <typename P, Format F, bool colorMapped>
+        void affineRowBilinear(P* bufPtr, int32_t u, int32_t v, uint count, const AffineMap& map);
+        template <Format F, bool colorMapped>
+        void sampleBilinear(const AffineMap& map, int32_t u, int32_t v, uint32_t& r, uint32_t& g, uint32_t& b, uint32_t& a, bool pixelAlpha);
+        template <Format F, bool colorMapped>
+        void readLinear(const AffineMap& map, int col, int row, uint32_t& r, uint32_t& g, uint32_t& b, uint32_t& a, bool pixelAlpha);
+        AffineDecoder selectAffineDecoder(bool bilinear);
+        template <Format F>
+        AffineDecoder affineDecoderFor(bool bilinear);
+        template <Format F, bool colorMapped>
+        void affineDecodeNearest(LinearPixel* out, int32_t u, int32_t v, uint count, const AffineMap& map, uint32_t spriteA, bool pixelAlpha);
+        template <Format F, bool colorMapped>
+        void affineDecodeBilinear(LinearPixel* out, int32_t u, int32_t v, uint count, const AffineMap& map, uint32_t spriteA, bool pixelAlpha);
+
+        struct Placement { // where the sprite is on the screen, for coverage queries
+            Rect rect; // from bounds()
+            Rect src; // from source()
+            AffineMap map; // if transformed
+        };
+
+        bool occludes();
+
+        bool place(Placement& placement);
+        bool covers(const Placement& placement, int screenX, int screenY);
+        uint imageRow(const Placement& placement, int screenY);
+        bool maskBit(uint row, uint col);
+        uint32_t maskBits(uint row, uint col);
+
+        template <Format F, typename RunFn>
+        void walkRLE(uint row, uint endCol, RunFn fn);
+        template <Format F>
+        void seekPixel(RowReader& rd, const uint8_t* rowPtr, uint col);
+        template <Format F>
+        uint readIndex(RowReader& rd);
+        template <Format F, bool pixelAlpha>
+        void readPixel(RowReader& rd, uint32_t& r, uint32_t& g, uint32_t& b, uint32_t& a);
+        void loadBitmap(const char* filename, void* destination, size_t allocatedSize, LoadMode mode);
+        bool loadStream(const char* filename, void* cache, size_t cacheSize);
+        LoadStatus failLoad();
+        void startConversion();
         void parseHeader(uint8_t* ptr);
-        uint32_t read32(uint8_t* ptr);
-        uint16_t read16(uint8_t* ptr);
+        static bool isBaked(const uint8_t* ptr, size_t size);
+        bool parseBaked(uint8_t* ptr);
+        void clearImage();
+        uint paletteEntries();
+        bool decodePalette(uint count);
+        static void decodeColor(PaletteColor& color, uint8_t r, uint8_t g, uint8_t b);
+        const PaletteColor* drawColors() { return mappedColors ? mappedColors.get() : paletteColors.get(); };
+        bool mapPalette(uint first, uint count);
+        static void mapColor(const ColorMap& map, uint32_t& r, uint32_t& g, uint32_t& b);
+        template <Format F>
+        static void mapPixel(const ColorMap& map, uint32_t& r, uint32_t& g, uint32_t& b);
+        template <typename P>
+        static P opaqueColor(const PaletteColor& color);
+        uint32_t unusedAlphaMask();
+        bool rowHasUnusedAlpha(uint row, uint32_t unusedMask);
+        bool prepareStream(uint firstRow, uint lastRow, uint col, uint count);
+        bool streamRowCached(uint row, uint col, uint count);
+        const uint8_t* streamRow(uint row, uint col, uint count, uint& segCol);
+        void readStreamRows(uint row, uint rows, uint segCol);
+        void addRowSpans(std::vector<uint16_t>& runs, uint row);
+        void finishSpanIndex(const std::vector<uint16_t>& runs, const std::vector<uint32_t>& rowOffsets);
+        void buildRLEIndex();
+        bool startMask();
+        void addRowMask(uint row);
+        template <Format F>
+        void addMask(uint row);
+        void buildMask();
+        template <Format F>
+        void addSpans(std::vector<uint16_t>& runs, uint row);
+        size_t convertedSize(LoadMode mode);
+        void convertImage(LoadMode mode, uint8_t* dest, uint firstRow, uint lastRow);
+        void finishConversion(LoadMode mode, uint8_t* dest);
+        template <Format F>
+        void convertRows(LoadMode mode, uint8_t* dest, uint firstRow, uint lastRow);
+        template <Format F>
+        void convertRLE(LoadMode mode, uint8_t* dest, uint firstRow, uint lastRow);
+        uint32_t read32(const uint8_t* ptr);
+        uint16_t read16(const uint8_t* ptr);
         uint8_t maskToScale(uint32_t mask);
         uint8_t maskToShift(uint32_t mask);
 };
@@ -0,0 +1,122 @@
+/*
+    Batched and table-driven gamma-correct blending for BitmapSprite.
+*/
+
+#include "BlendBatch.h"
+
+#if !defined(BITMAPSPRITE_SCALAR_BLEND)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define BLEND_AVX2
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define BLEND_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define BLEND_NEON
+#endif
+#endif
+
+#if defined(BLEND_AVX2)
+static inline __m256i lerpLanes(__m256i s, __m256i d, __m256i a) {
+    // same as the SSE2 version below, 16 lanes at a time
+    __m256i b = _mm256_sub_epi16(_mm256_setzero_si256(), a); // 65536 - a, since a >= 1
+    __m256i loS = _mm256_mullo_epi16(a, s);
+    __m256i loD = _mm256_mullo_epi16(b, d);
+    __m256i lo = _mm256_add_epi16(loS, loD);
+    __m256i noCarry = _mm256_cmpeq_epi16(lo, _mm256_adds_epu16(loS, loD));
+    __m256i hi = _mm256_add_epi16(_mm256_mulhi_epu16(a, s), _mm256_mulhi_epu16(b, d));
+    return _mm256_add_epi16(hi, _mm256_andnot_si256(noCarry, _mm256_set1_epi16(1)));
+}
+#endif
+
+#if defined(BLEND_SSE2) || defined(BLEND_AVX2)
+static inline __m128i lerpLanes(__m128i s, __m128i d, __m128i a) {
+    // (a * s + (65536 - a) * d) >> 16, which equals d + floor(a * (s - d) / 65536).
+    // The products are split into 16-bit halves, so the result is the sum of the high halves
+    // plus the carry out of the sum of the low halves.
+    __m128i b = _mm_sub_epi16(_mm_setzero_si128(), a); // 65536 - a, since a >= 1
+    __m128i loS = _mm_mullo_epi16(a, s);
+    __m128i loD = _mm_mullo_epi16(b, d);
+    __m128i lo = _mm_add_epi16(loS, loD);
+    __m128i noCarry = _mm_cmpeq_epi16(lo, _mm_adds_epu16(loS, loD));
+    __m128i hi = _mm_add_epi16(_mm_mulhi_epu16(a, s), _mm_mulhi_epu16(b, d));
+    return _mm_add_epi16(hi, _mm_andnot_si128(noCarry, _mm_set1_epi16(1)));
+}
+#endif
+
+void blendLerp16(uint16_t* src, const uint16_t* dst, const uint16_t* a, uint n) {
+    uint i = 0;
+
+#if defined(BLEND_AVX2)
+    for (; i + 16 <= n; i += 16) {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i f = _mm256_loadu_si256((const __m256i*)(a + i));
+        _mm256_storeu_si256((__m256i*)(src + i), lerpLanes(s, d, f));
+    }
+#endif
+
+#if defined(BLEND_SSE2) || defined(BLEND_AVX2)
+    for (; i + 8 <= n; i += 8) {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i f = _mm_loadu_si128((const __m128i*)(a + i));
+        _mm_storeu_si128((__m128i*)(src + i), lerpLanes(s, d, f));
+    }
+#endif
+
+#if defined(BLEND_NEON)
+    for (; i + 8 <= n; i += 8) {
+        // (a * s + (65536 - a) * d) >> 16, with 32-bit products
+        uint16x8_t s = vld1q_u16(src + i);
+        uint16x8_t d = vld1q_u16(dst + i);
+        uint16x8_t f = vld1q_u16(a + i);
+        uint16x8_t b = vsubq_u16(vdupq_n_u16(0), f); // 65536 - a, since a >= 1
+        uint32x4_t lo = vmlal_u16(vmull_u16(vget_low_u16(f), vget_low_u16(s)), vget_low_u16(b), vget_low_u16(d));
+        uint32x4_t hi = vmlal_u16(vmull_u16(vget_high_u16(f), vget_high_u16(s)), vget_high_u16(b), vget_high_u16(d));
+        vst1q_u16(src + i, vcombine_u16(vshrn_n_u32(lo, 16), vshrn_n_u32(hi, 16)));
+    }
+#endif
+
+    for (; i < n; i++) {
+        src[i] = lerp16(src[i], dst[i], a[i]);
+    }
+}
+
+// the last few fade tables built, per thread when SpriteBatch renders on several
+static const uint FADE_TABLES = 2;
+#if defined(BITMAPSPRITE_THREADS)
+static thread_local FadeTable fadeTables[FADE_TABLES];
+static thread_local uint fadeNext = 0;
+#else
+static FadeTable fadeTables[FADE_TABLES];
+static uint fadeNext = 0;
+#endif
+
+const FadeTable* FadeTable::find(uint8_t alpha) {
+    if (alpha == 0) return nullptr;
+    for (uint i = 0; i < FADE_TABLES; i++) {
+        if (fadeTables[i].alpha == alpha) return &fadeTables[i];
+    }
+    return nullptr;
+}
+
+const FadeTable* FadeTable::prepare(uint8_t alpha) {
+    const FadeTable* found = find(alpha);
+    if (found) return found;
+
+    // replace the oldest table
+    FadeTable& table = fadeTables[fadeNext];
+    fadeNext = (fadeNext + 1) % FADE_TABLES;
+
+    uint32_t a = alpha * 257;
+    for (uint i = 0; i < 256; i++) {
+        uint32_t c = decodeGamma8to16(i);
+        table.src[i] = a * c;
+        table.dst[i] = (65536 - a) * c;
+        table.pixel[i] = i * alpha * 257 / 255;
+    }
+    table.alpha = alpha;
+    return &table;
+}
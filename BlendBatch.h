@@ -0,0 +1,233 @@
+/*
+    Gamma-correct blending for BitmapSprite row kernels.
+
+    Kernels hand each translucent pixel to a BlendBatch. By default the pixel is blended immediately,
+    using the Cortex-M7 DSP instructions on Teensy 4.x. With BITMAPSPRITE_BATCH_BLEND defined,
+    pixels are queued and blended several at a time with SSE2/AVX2 or NEON instead.
+    The batched path only pays off where the blend is not bound by gamma table lookups,
+    so measure it with the benchmark before enabling it.
+    All paths give bit-identical results. Define BITMAPSPRITE_SCALAR_BLEND to use plain C only.
+
+    The drawing buffer can hold rgb16, rgb24 or rgb48 pixels (see DestPixel). rgb48 pixels are decoded
+    and encoded with 16-bit gamma tables, so blends keep 16 bits per channel throughout.
+    linear48 pixels are already linear, so blending into them needs no table lookups at all.
+
+    Sprites faded with a constant alpha blend every pixel with the same factor. For them, a FadeTable holds
+    both halves of the blend already multiplied out, for every 8-bit channel value.
+*/
+
+#ifndef BlendBatch_h
+#define BlendBatch_h
+
+#include <Arduino.h>
+#include <MatrixCommon.h> // from SmartMatrix library
+#include "gammaLUT.h"
+#include "BitmapSprite.h" // linear48
+
+#if defined(__ARM_FEATURE_DSP) && !defined(BITMAPSPRITE_SCALAR_BLEND)
+#define BLEND_DSP
+#endif
+
+inline uint32_t lerp16(uint32_t s, uint32_t d, uint32_t a) {
+    // Blends one 16-bit linear channel: d + a * (s - d) / 65536, rounded down. a must be below 0x10000.
+#if defined(BLEND_DSP)
+    // SMLAWB computes base + (diff * signed16(a)) >> 16 in one instruction.
+    // For a >= 0x8000 the halfword reads as a - 65536, which subtracts exactly diff: start from s instead of d.
+    int32_t diff = s - d;
+    uint32_t base = (a & 0x8000) ? s : d;
+    uint32_t out;
+    asm ("smlawb %0, %1, %2, %3" : "=r" (out) : "r" (diff), "r" (a), "r" (base));
+    return (uint16_t)out;
+#else
+    return (uint16_t)(d + ((a * (s - d)) >> 16));
+#endif
+}
+
+// Drawing buffer pixel types: how to store a color, and how to read a pixel back as 16-bit linear color.
+template <typename P>
+struct DestPixel;
+
+template <>
+struct DestPixel<rgb16> {
+    static inline rgb16 fromSRGB8(uint32_t r, uint32_t g, uint32_t b) {
+        return rgb16(r >> 3, g >> 2, b >> 3);
+    }
+    static inline rgb16 fromLinear16(uint32_t r, uint32_t g, uint32_t b) {
+        return rgb16(encodeGamma16to8(r) >> 3, encodeGamma16to8(g) >> 2, encodeGamma16to8(b) >> 3);
+    }
+    static inline void toLinear16(const rgb16& p, uint32_t& r, uint32_t& g, uint32_t& b) {
+        r = decodeGamma8to16((p.red << 3) | (p.red >> 2));
+        g = decodeGamma8to16((p.green << 2) | (p.green >> 4));
+        b = decodeGamma8to16((p.blue << 3) | (p.blue >> 2));
+    }
+};
+
+template <>
+struct DestPixel<rgb24> {
+    static inline rgb24 fromSRGB8(uint32_t r, uint32_t g, uint32_t b) {
+        return rgb24(r, g, b);
+    }
+    static inline rgb24 fromLinear16(uint32_t r, uint32_t g, uint32_t b) {
+        return rgb24(encodeGamma16to8(r), encodeGamma16to8(g), encodeGamma16to8(b));
+    }
+    static inline void toLinear16(const rgb24& p, uint32_t& r, uint32_t& g, uint32_t& b) {
+        r = decodeGamma8to16(p.red);
+        g = decodeGamma8to16(p.green);
+        b = decodeGamma8to16(p.blue);
+    }
+};
+
+template <>
+struct DestPixel<rgb48> {
+    static inline rgb48 fromSRGB8(uint32_t r, uint32_t g, uint32_t b) {
+        return rgb48(r * 257, g * 257, b * 257);
+    }
+    static inline rgb48 fromLinear16(uint32_t r, uint32_t g, uint32_t b) {
+        return rgb48(encodeGamma16to16(r), encodeGamma16to16(g), encodeGamma16to16(b));
+    }
+    static inline void toLinear16(const rgb48& p, uint32_t& r, uint32_t& g, uint32_t& b) {
+        r = decodeGamma16to16(p.red);
+        g = decodeGamma16to16(p.green);
+        b = decodeGamma16to16(p.blue);
+    }
+};
+
+template <>
+struct DestPixel<linear48> {
+    static inline linear48 fromSRGB8(uint32_t r, uint32_t g, uint32_t b) {
+        return linear48(decodeGamma8to16(r), decodeGamma8to16(g), decodeGamma8to16(b));
+    }
+    static inline linear48 fromLinear16(uint32_t r, uint32_t g, uint32_t b) {
+        return linear48(r, g, b);
+    }
+    static inline void toLinear16(const linear48& p, uint32_t& r, uint32_t& g, uint32_t& b) {
+        r = p.red;
+        g = p.green;
+        b = p.blue;
+    }
+};
+
+// Blend coefficients for one sprite alpha. lerp16(s, d, a) equals (a * s + (65536 - a) * d) >> 16, so with a fixed
+// both products can be looked up for 8-bit sRGB source and buffer channels: no multiplies and no source decoding
+// per pixel, with the same results. The pixel table scales alpha channel values by the sprite alpha without
+// a division. Building a table takes about as long as blending a few hundred pixels, so the renderer only builds
+// one for sprites covering at least MIN_PIXELS, and keeps the last few (per thread) for the next renders.
+struct FadeTable {
+    static const uint MIN_PIXELS = 256;
+
+    uint8_t alpha; // 0 while unused: the kept tables are static, so they start zeroed
+    uint32_t src[256]; // alpha * 257 * decoded source channel
+    uint32_t dst[256]; // (65536 - alpha * 257) * decoded buffer channel
+    uint16_t pixel[256]; // i * alpha * 257 / 255, the blend factor of a pixel with alpha channel value i
+
+    // Returns the table for a sprite alpha in 1..254, building it if it is not kept already.
+    static const FadeTable* prepare(uint8_t alpha);
+    // Returns the table for a sprite alpha if it is kept, or nullptr.
+    static const FadeTable* find(uint8_t alpha);
+};
+
+// Blending with a FadeTable, for drawing buffers with 8-bit sRGB channels (rgb16 and rgb24).
+template <typename P>
+struct FadePixel {
+    static const bool SUPPORTED = false;
+    static inline void blend(P*, const FadeTable&, uint32_t, uint32_t, uint32_t) {}
+};
+
+template <>
+struct FadePixel<rgb16> {
+    static const bool SUPPORTED = true;
+    static inline void blend(rgb16* bufPtr, const FadeTable& table, uint32_t r, uint32_t g, uint32_t b) {
+        // the buffer channels are widened to 8 bits, as in DestPixel<rgb16>::toLinear16
+        const rgb16& p = *bufPtr;
+        uint32_t dr = (p.red << 3) | (p.red >> 2);
+        uint32_t dg = (p.green << 2) | (p.green >> 4);
+        uint32_t db = (p.blue << 3) | (p.blue >> 2);
+        *bufPtr = DestPixel<rgb16>::fromLinear16((table.src[r] + table.dst[dr]) >> 16, (table.src[g] + table.dst[dg]) >> 16, (table.src[b] + table.dst[db]) >> 16);
+    }
+};
+
+template <>
+struct FadePixel<rgb24> {
+    static const bool SUPPORTED = true;
+    static inline void blend(rgb24* bufPtr, const FadeTable& table, uint32_t r, uint32_t g, uint32_t b) {
+        const rgb24& p = *bufPtr;
+        *bufPtr = DestPixel<rgb24>::fromLinear16((table.src[r] + table.dst[p.red]) >> 16, (table.src[g] + table.dst[p.green]) >> 16, (table.src[b] + table.dst[p.blue]) >> 16);
+    }
+};
+
+// Blends n values of one color channel in place with lerp16, several at a time where SIMD is available.
+// Each blend factor must be in 1..0xFFFE.
+void blendLerp16(uint16_t* src, const uint16_t* dst, const uint16_t* a, uint n);
+
+#if defined(BITMAPSPRITE_BATCH_BLEND)
+
+template <typename P>
+class BlendBatch {
+    public:
+        static const uint SIZE = 32;
+
+        // Queues one pixel for blending: 16-bit linear source color, blend factor in 1..0xFFFE.
+        inline void add(P* bufPtr, uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+            dest[count] = bufPtr;
+            red[count] = r;
+            green[count] = g;
+            blue[count] = b;
+            factor[count] = a;
+            if (++count == SIZE) flush();
+        }
+
+        // Blends all queued pixels into their destinations. Must be called before the destinations are read again.
+        void flush();
+
+    private:
+        uint count = 0;
+        P* dest[SIZE];
+        alignas(32) uint16_t red[SIZE];
+        alignas(32) uint16_t green[SIZE];
+        alignas(32) uint16_t blue[SIZE];
+        alignas(32) uint16_t factor[SIZE];
+};
+
+template <typename P>
+void BlendBatch<P>::flush() {
+    // decode the destination pixels, blend each channel across the batch, then encode and store
+    alignas(32) uint16_t redDest[SIZE];
+    alignas(32) uint16_t greenDest[SIZE];
+    alignas(32) uint16_t blueDest[SIZE];
+
+    for (uint i = 0; i < count; i++) {
+        uint32_t r, g, b;
+        DestPixel<P>::toLinear16(*dest[i], r, g, b);
+        redDest[i] = r;
+        greenDest[i] = g;
+        blueDest[i] = b;
+    }
+
+    blendLerp16(red, redDest, factor, count);
+    blendLerp16(green, greenDest, factor, count);
+    blendLerp16(blue, blueDest, factor, count);
+
+    for (uint i = 0; i < count; i++) {
+        *dest[i] = DestPixel<P>::fromLinear16(red[i], green[i], blue[i]);
+    }
+    count = 0;
+}
+
+#else
+
+template <typename P>
+class BlendBatch {
+    public:
+        // Blends one pixel: 16-bit linear source color, blend factor in 1..0xFFFE.
+        inline void add(P* bufPtr, uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+            uint32_t dr, dg, db;
+            DestPixel<P>::toLinear16(*bufPtr, dr, dg, db);
+            *bufPtr = DestPixel<P>::fromLinear16(lerp16(r, dr, a), lerp16(g, dg, a), lerp16(b, db, a));
+        }
+
+        inline void flush() {}
+};
+
+#endif
+
+#endif
@@ -0,0 +1,120 @@
+/*
+    LinearBuffer Class for use with BitmapSprite.
+
+    Display-sized 16-bit linear scratch buffer, gamma-encoded into the drawing buffer once per frame.
+*/
+
+#include "LinearBuffer.h"
+#include "BlendBatch.h"
+
+#include <algorithm>
+
+LinearBuffer::LinearBuffer() {
+    // The buffer is dynamically allocated on first use, sized for the display.
+}
+
+LinearBuffer::LinearBuffer(void* memory, size_t allocatedSize) {
+    // Uses a statically allocated memory range: it must hold 6 bytes per display pixel.
+    // note: since the memory is statically allocated, do not initialize the shared_ptr.
+    pixels = (linear48*)(((uintptr_t)memory + 1) & ~(uintptr_t)1); // align to 16 bits
+    size_t skipped = (uint8_t*)pixels - (uint8_t*)memory;
+    size = allocatedSize > skipped ? allocatedSize - skipped : 0;
+}
+
+linear48* LinearBuffer::buffer() {
+    // Returns the display-sized buffer to render sprites into, or nullptr if there is not enough memory.
+    // The contents are undefined after the display size changed; call clear() or load() first.
+    uint16_t matrixWidth = BitmapSprite::matrixWidth;
+    uint16_t matrixHeight = BitmapSprite::matrixHeight;
+    if (matrixWidth == 0 || matrixHeight == 0) return nullptr; // display size not set
+
+    size_t needed = (size_t)matrixWidth * matrixHeight * sizeof(linear48);
+    if (!pixels || (memory && size != needed)) {
+        // dynamically allocate, or reallocate for a new display size
+        memory.reset(new linear48[(size_t)matrixWidth * matrixHeight], std::default_delete<linear48[]>());
+
+        if (!memory) {
+            Serial.println("Error: Failed to allocate memory.");
+            pixels = nullptr;
+            size = 0;
+            return nullptr;
+        }
+        pixels = memory.get();
+        size = needed;
+    }
+
+    if (size < needed) {
+        Serial.println("Error: Not enough memory for the linear buffer.");
+        return nullptr;
+    }
+    width = matrixWidth;
+    height = matrixHeight;
+    return pixels;
+}
+
+void LinearBuffer::clear() {
+    // Fills the buffer with black, to start a frame without a background.
+    linear48* ptr = buffer();
+    if (ptr) std::fill(ptr, ptr + (size_t)width * height, linear48());
+}
+
+template <typename P>
+void LinearBuffer::load(const P* source) {
+    // Fills the buffer with a display-sized image, e.g. the background of the frame, decoded to linear light.
+    // To restore a static background every frame, load it into a second LinearBuffer once and copy that:
+    // SpriteBatch::renderDirty() accepts a linear48 background.
+    linear48* ptr = buffer();
+    if (!ptr) return;
+
+    for (size_t i = 0; i < (size_t)width * height; i++) {
+        uint32_t r, g, b;
+        DestPixel<P>::toLinear16(source[i], r, g, b);
+        ptr[i] = linear48(r, g, b);
+    }
+}
+
+template <typename P>
+void LinearBuffer::encode(P* destination) {
+    // Gamma-encodes the whole buffer into a display-sized drawing buffer.
+    encode(destination, {0, 0, width - 1, height - 1});
+}
+
+template <typename P>
+void LinearBuffer::encode(P* destination, const BitmapSprite::Rect& rect) {
+    // Gamma-encodes the part of the buffer within rect (screen coordinates) into the drawing buffer,
+    // e.g. only the rectangles returned by SpriteBatch::renderDirty().
+    if (!pixels || width == 0) return;
+
+    int left = max(rect.left, 0);
+    int right = min(rect.right, width - 1);
+    int top = max(rect.top, 0);
+    int bottom = min(rect.bottom, height - 1);
+
+    for (int y = top; y <= bottom; y++) {
+        const linear48* src = pixels + y * width + left;
+        P* dst = destination + y * width + left;
+        for (int x = left; x <= right; x++, src++) {
+            *dst++ = DestPixel<P>::fromLinear16(src->red, src->green, src->blue);
+        }
+    }
+}
+
+template <typename P>
+void LinearBuffer::encode(P* destination, const std::vector<BitmapSprite::Rect>& rects) {
+    // Gamma-encodes the parts of the buffer within a list of rectangles into the drawing buffer.
+    for (const BitmapSprite::Rect& rect : rects) encode(destination, rect);
+}
+
+// load() and encode() are compiled for each drawing buffer pixel type
+template void LinearBuffer::load<rgb16>(const rgb16* source);
+template void LinearBuffer::load<rgb24>(const rgb24* source);
+template void LinearBuffer::load<rgb48>(const rgb48* source);
+template void LinearBuffer::encode<rgb16>(rgb16* destination);
+template void LinearBuffer::encode<rgb24>(rgb24* destination);
+template void LinearBuffer::encode<rgb48>(rgb48* destination);
+template void LinearBuffer::encode<rgb16>(rgb16* destination, const BitmapSprite::Rect& rect);
+template void LinearBuffer::encode<rgb24>(rgb24* destination, const BitmapSprite::Rect& rect);
+template void LinearBuffer::encode<rgb48>(rgb48* destination, const BitmapSprite::Rect& rect);
+template void LinearBuffer::encode<rgb16>(rgb16* destination, const std::vector<BitmapSprite::Rect>& rects);
+template void LinearBuffer::encode<rgb24>(rgb24* destination, const std::vector<BitmapSprite::Rect>& rects);
+template void LinearBuffer::encode<rgb48>(rgb48* destination, const std::vector<BitmapSprite::Rect>& rects);
@@ -0,0 +1,42 @@
+/*
+    LinearBuffer Class for use with BitmapSprite.
+
+    A display-sized scratch buffer holding 16-bit linear light per channel. Sprites (or a SpriteBatch) are
+    rendered into it instead of the SmartMatrix back buffer, then the frame is gamma-encoded into the back
+    buffer once. Each translucent layer then costs a blend only, and overlapping layers add no rounding:
+    the 8-bit (or 16-bit) encode happens once per pixel instead of once per layer.
+*/
+
+#ifndef LinearBuffer_h
+#define LinearBuffer_h
+
+#include "BitmapSprite.h"
+
+#include <memory>
+#include <vector>
+
+class LinearBuffer {
+    public:
+        LinearBuffer();
+        LinearBuffer(void* memory, size_t allocatedSize);
+
+        linear48* buffer();
+        void clear();
+        template <typename P>
+        void load(const P* source);
+        template <typename P>
+        void encode(P* destination);
+        template <typename P>
+        void encode(P* destination, const BitmapSprite::Rect& rect);
+        template <typename P>
+        void encode(P* destination, const std::vector<BitmapSprite::Rect>& rects);
+
+    private:
+        std::shared_ptr<linear48> memory; // dynamically allocated pixels, if no memory was provided
+        linear48* pixels = nullptr;
+        size_t size = 0; // bytes of pixel memory
+        uint16_t width = 0; // display size the pixels are laid out for
+        uint16_t height = 0;
+};
+
+#endif
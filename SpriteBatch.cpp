@@ -0,0 +1,446 @@
+/*
+    SpriteBatch Class for use with BitmapSprite.
+
+    Renders many sprites per frame in one pass over the drawing buffer.
+*/
+
+#include "SpriteBatch.h"
+
+#include <string.h>
+#include <algorithm>
+
+#if defined(BITMAPSPRITE_THREADS)
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+class SpriteBatch::Workers {
+    // A pool of threads that share out numbered jobs: each thread, including the caller's, takes the next
+    // job from a shared counter until none are left, so threads that finish early take over the rest.
+    public:
+        Workers(uint count) {
+            for (uint i = 0; i < count; i++) threads.emplace_back([this]() { work(); });
+        }
+
+        ~Workers() {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                quit = true;
+            }
+            wake.notify_all();
+            for (std::thread& thread : threads) thread.join();
+        }
+
+        uint size() { return threads.size(); }
+
+        // Calls job(i) for each i in 0..count-1 on all threads, and returns once every call has finished.
+        void run(uint count, const std::function<void(uint)>& job) {
+            std::lock_guard<std::mutex> runLock(runMutex); // batches sharing the pool take turns
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                this->job = &job;
+                total = count;
+                next = 0;
+                busy = threads.size();
+                generation++;
+            }
+            wake.notify_all();
+            take();
+
+            std::unique_lock<std::mutex> lock(mutex);
+            done.wait(lock, [this]() { return busy == 0; });
+        }
+
+    private:
+        std::vector<std::thread> threads;
+        std::mutex runMutex;
+        std::mutex mutex; // guards the fields below, except next
+        std::condition_variable wake;
+        std::condition_variable done;
+        const std::function<void(uint)>* job = nullptr;
+        uint total = 0;
+        std::atomic<uint> next{0};
+        uint busy = 0; // worker threads still taking jobs
+        uint generation = 0; // counts run() calls, so workers wake once per run
+        bool quit = false;
+
+        void take() {
+            for (uint i = next++; i < total; i = next++) (*job)(i);
+        }
+
+        void work() {
+            uint seen = 0;
+            std::unique_lock<std::mutex> lock(mutex);
+            while (true) {
+                wake.wait(lock, [&]() { return quit || generation != seen; });
+                if (quit) return;
+                seen = generation;
+                lock.unlock();
+                take();
+                lock.lock();
+                if (--busy == 0) done.notify_one();
+            }
+        }
+};
+
+void SpriteBatch::setThreads(uint count) {
+    // Sets how many threads render() uses, including the calling thread. With 1, the default, it renders
+    // on the calling thread only. Copies of the batch share the threads.
+    if (count <= 1) {
+        workers.reset();
+    } else if (threads() != count) {
+        workers = std::make_shared<Workers>(count - 1);
+    }
+}
+
+uint SpriteBatch::threads() {
+    // Returns how many threads render() uses.
+    return workers ? workers->size() + 1 : 1;
+}
+#endif
+
+struct SpriteBatch::Scratch {
+    struct Cover { // screen columns hidden by an opaque sprite
+        int left;
+        int right;
+        uint owner; // the sprite, numbered by z-order within the band
+    };
+
+    std::vector<uint> occluders; // opaque sprites of the band, front to back
+    std::vector<int> edges; // rows where an opaque sprite starts or ends, in order
+    std::vector<Cover> covers; // covered columns of a strip of rows, in order, not overlapping
+    std::vector<Cover> merged;
+};
+
+SpriteBatch::SpriteBatch(uint16_t bandHeight) : bandHeight(bandHeight ? bandHeight : 1) {
+}
+
+void SpriteBatch::clear() {
+    // Removes all sprites, to start a new frame. Memory is kept for reuse.
+    sprites.clear();
+}
+
+void SpriteBatch::add(BitmapSprite& sprite) {
+    // Adds a sprite on top of the sprites already added.
+    // The sprite is rendered at its position and alpha at the time of the next render() call.
+    Entry entry;
+    entry.sprite = &sprite;
+    sprites.push_back(entry);
+}
+
+void SpriteBatch::invalidate() {
+    // Makes the next renderDirty() call redraw the whole display, e.g. after the background has changed.
+    fullRedraw = true;
+}
+
+template <typename P>
+void SpriteBatch::render(P* buffer) {
+    // Renders all sprites to the provided drawing buffer, one band of rows at a time.
+    uint16_t matrixWidth = BitmapSprite::matrixWidth;
+    uint16_t matrixHeight = BitmapSprite::matrixHeight;
+    if (matrixWidth == 0 || matrixHeight == 0) return; // display size not set
+
+    uint16_t numBands = (matrixHeight + bandHeight - 1) / bandHeight;
+    binSprites(numBands);
+
+    BitmapSprite::Rect rect = {0, 0, matrixWidth - 1, matrixHeight - 1};
+#if defined(BITMAPSPRITE_THREADS)
+    if (workers && !streamed) {
+        // bands do not overlap, so they can be composited in any order, on any thread
+        workers->run(numBands, [&](uint band) { renderBand(buffer, rect, band); });
+        return;
+    }
+#endif
+    renderRect(buffer, rect);
+}
+
+bool SpriteBatch::sameTransform(const Entry& a, const Entry& b) {
+    // helper function returns whether two entries were drawn with the same transform, if any
+    if (a.transformed != b.transformed) return 0;
+    if (!a.transformed) return 1;
+    const BitmapSprite::Transform& p = a.transform;
+    const BitmapSprite::Transform& q = b.transform;
+    return p.x == q.x && p.y == q.y && p.scaleX == q.scaleX && p.scaleY == q.scaleY && p.angle == q.angle && p.bilinear == q.bilinear;
+}
+
+template <typename P>
+const std::vector<BitmapSprite::Rect>& SpriteBatch::renderDirty(P* buffer, const typename std::decay<P>::type* background) {
+    // Redraws only the screen areas where sprites were added, removed, moved, faded or changed since the
+    // last renderDirty() call: the background is restored there and the overlapping sprites are drawn again.
+    // The buffer must still hold the previous frame (with SmartMatrix, use swapBuffers(true)).
+    // background is a display-sized image, or nullptr for black.
+    // Returns the redrawn rectangles; they do not overlap.
+    uint16_t matrixWidth = BitmapSprite::matrixWidth;
+    uint16_t matrixHeight = BitmapSprite::matrixHeight;
+    dirty.clear();
+    if (matrixWidth == 0 || matrixHeight == 0) return dirty; // display size not set
+
+    uint16_t numBands = (matrixHeight + bandHeight - 1) / bandHeight;
+    binSprites(numBands);
+
+    if (fullRedraw || matrixWidth != previousWidth || matrixHeight != previousHeight) {
+        dirty.push_back({0, 0, matrixWidth - 1, matrixHeight - 1});
+    } else {
+        // compare sprites by z-order position: a change in stacking order dirties both positions
+        for (size_t i = 0; i < max(sprites.size(), previous.size()); i++) {
+            if (i >= previous.size()) {
+                addDirty(sprites[i].rect);
+            } else if (i >= sprites.size()) {
+                addDirty(previous[i].rect);
+            } else {
+                const Entry& a = sprites[i];
+                const Entry& b = previous[i];
+                bool aEmpty = a.rect.bottom < a.rect.top;
+                bool bEmpty = b.rect.bottom < b.rect.top;
+                if (aEmpty && bEmpty) continue;
+                if (aEmpty == bEmpty && a.sprite == b.sprite && a.alpha == b.alpha && a.blend == b.blend && a.image == b.image && a.colorChanges == b.colorChanges &&
+                    a.frame.left == b.frame.left && a.frame.top == b.frame.top && sameTransform(a, b) &&
+                    a.rect.left == b.rect.left && a.rect.top == b.rect.top && a.rect.right == b.rect.right && a.rect.bottom == b.rect.bottom) continue;
+                addDirty(a.rect);
+                addDirty(b.rect);
+            }
+        }
+        mergeDirty();
+    }
+
+    for (const BitmapSprite::Rect& rect : dirty) {
+        // restore the background
+        uint count = rect.right - rect.left + 1;
+        for (int row = rect.top; row <= rect.bottom; row++) {
+            P* bufPtr = buffer + row * matrixWidth + rect.left;
+            if (background) memcpy(bufPtr, background + row * matrixWidth + rect.left, count * sizeof(P));
+            else std::fill(bufPtr, bufPtr + count, P());
+        }
+        renderRect(buffer, rect);
+    }
+
+    previous = sprites;
+    previousWidth = matrixWidth;
+    previousHeight = matrixHeight;
+    fullRedraw = false;
+    return dirty;
+}
+
+template <typename P>
+void SpriteBatch::renderRect(P* buffer, const BitmapSprite::Rect& rect) {
+    // helper function draws the binned sprites within rect, band by band
+    int firstBand = rect.top / bandHeight;
+    int lastBand = rect.bottom / bandHeight;
+
+    for (int band = firstBand; band <= lastBand; band++) renderBand(buffer, rect, band);
+}
+
+template <typename P>
+void SpriteBatch::renderBand(P* buffer, const BitmapSprite::Rect& rect, int band) {
+    // helper function draws the sprites binned to one band, in z-order, within rect
+    BitmapSprite::Rect clip = rect;
+    clip.top = max(rect.top, band * bandHeight);
+    clip.bottom = min(rect.bottom, (band + 1) * bandHeight - 1);
+
+    if (occlusion && binStart[band + 1] - binStart[band] > 1) {
+        renderOccluded(buffer, clip, band);
+        return;
+    }
+
+    for (uint32_t i = binStart[band]; i < binStart[band + 1]; i++) {
+        Entry& entry = sprites[bins[i]];
+        entry.sprite->renderClipped(buffer, entry.rect, clip);
+    }
+}
+
+template <typename P>
+void SpriteBatch::renderOccluded(P* buffer, const BitmapSprite::Rect& clip, int band) {
+    // helper function draws the sprites binned to one band within clip, culling hidden pixels. Sprites in the band
+    // are numbered by z-order. The band is cut into strips of rows at the top and bottom edges of opaque sprites,
+    // so within a strip each opaque sprite covers all rows or none. Going front to back, each strip records which
+    // sprite is the first to cover each column, as spans: that sprite hides everything behind it. Then each sprite
+    // is drawn back to front as usual, except where a sprite in front of it is opaque.
+#if defined(BITMAPSPRITE_THREADS)
+    static thread_local Scratch scratch; // kept between frames, so the vectors keep their memory
+#else
+    static Scratch scratch;
+#endif
+    uint32_t first = binStart[band];
+    uint count = binStart[band + 1] - first;
+
+    scratch.occluders.clear();
+    scratch.edges.clear();
+    scratch.edges.push_back(clip.top);
+    for (uint k = count; k-- > 0;) {
+        const Entry& entry = sprites[bins[first + k]];
+        if (!entry.sprite->occludes()) continue;
+        scratch.occluders.push_back(k);
+        if (entry.rect.top > clip.top && entry.rect.top <= clip.bottom) scratch.edges.push_back(entry.rect.top);
+        if (entry.rect.bottom >= clip.top && entry.rect.bottom < clip.bottom) scratch.edges.push_back(entry.rect.bottom + 1);
+    }
+    if (scratch.occluders.empty()) {
+        for (uint k = 0; k < count; k++) {
+            const Entry& entry = sprites[bins[first + k]];
+            entry.sprite->renderClipped(buffer, entry.rect, clip);
+        }
+        return;
+    }
+    std::sort(scratch.edges.begin(), scratch.edges.end());
+    scratch.edges.erase(std::unique(scratch.edges.begin(), scratch.edges.end()), scratch.edges.end());
+    scratch.edges.push_back(clip.bottom + 1);
+
+    for (size_t strip = 0; strip + 1 < scratch.edges.size(); strip++) {
+        int top = scratch.edges[strip];
+        int bottom = scratch.edges[strip + 1] - 1;
+
+        // merge the opaque sprites over the strip into the covers: where a sprite in front covers a column already,
+        // it keeps it
+        std::vector<Scratch::Cover>& covers = scratch.covers;
+        covers.clear();
+        for (uint k : scratch.occluders) {
+            const BitmapSprite::Rect& rect = sprites[bins[first + k]].rect;
+            if (rect.top > top || rect.bottom < bottom) continue;
+            int left = max(rect.left, clip.left);
+            int right = min(rect.right, clip.right);
+
+            std::vector<Scratch::Cover>& merged = scratch.merged;
+            merged.clear();
+            size_t j = 0;
+            while (j < covers.size() && covers[j].right < left) merged.push_back(covers[j++]);
+            for (int x = left; x <= right;) {
+                if (j < covers.size() && covers[j].left <= x) {
+                    x = covers[j].right + 1;
+                    merged.push_back(covers[j++]);
+                } else {
+                    int last = (j < covers.size()) ? min(right, covers[j].left - 1) : right;
+                    merged.push_back({x, last, k});
+                    x = last + 1;
+                }
+            }
+            merged.insert(merged.end(), covers.begin() + j, covers.end());
+            covers.swap(merged);
+        }
+
+        // draw the columns of each sprite that no sprite in front of it covers
+        for (uint k = 0; k < count; k++) {
+            const Entry& entry = sprites[bins[first + k]];
+            BitmapSprite::Rect part;
+            part.top = max(entry.rect.top, top);
+            part.bottom = min(entry.rect.bottom, bottom);
+            if (part.top > part.bottom) continue;
+            int right = min(entry.rect.right, clip.right);
+
+            int x = max(entry.rect.left, clip.left);
+            for (const Scratch::Cover& cover : covers) {
+                if (cover.left > right) break;
+                if (cover.owner <= k || cover.right < x) continue;
+                if (cover.left > x) {
+                    part.left = x;
+                    part.right = cover.left - 1;
+                    entry.sprite->renderClipped(buffer, entry.rect, part);
+                }
+                x = cover.right + 1;
+            }
+            if (x <= right) {
+                part.left = x;
+                part.right = right;
+                entry.sprite->renderClipped(buffer, entry.rect, part);
+            }
+        }
+    }
+}
+
+void SpriteBatch::addDirty(const BitmapSprite::Rect& rect) {
+    // helper function adds the visible part of a sprite rectangle to the dirty list
+    BitmapSprite::Rect clipped;
+    clipped.left = max(rect.left, 0);
+    clipped.top = max(rect.top, 0);
+    clipped.right = min(rect.right, BitmapSprite::matrixWidth - 1);
+    clipped.bottom = min(rect.bottom, BitmapSprite::matrixHeight - 1);
+    if (clipped.left > clipped.right || clipped.top > clipped.bottom) return;
+    dirty.push_back(clipped);
+}
+
+void SpriteBatch::mergeDirty() {
+    // helper function replaces overlapping or touching dirty rectangles by their bounding box,
+    // until none are left, so that no area is redrawn twice
+    bool merged = true;
+    while (merged) {
+        merged = false;
+        for (size_t i = 0; i < dirty.size(); i++) {
+            for (size_t j = i + 1; j < dirty.size(); j++) {
+                BitmapSprite::Rect& a = dirty[i];
+                const BitmapSprite::Rect& b = dirty[j];
+                if (a.left > b.right + 1 || b.left > a.right + 1 || a.top > b.bottom + 1 || b.top > a.bottom + 1) continue;
+
+                a.left = min(a.left, b.left);
+                a.top = min(a.top, b.top);
+                a.right = max(a.right, b.right);
+                a.bottom = max(a.bottom, b.bottom);
+                dirty[j] = dirty.back();
+                dirty.pop_back();
+                merged = true;
+                j = i; // recheck the grown rectangle against all others
+            }
+        }
+    }
+}
+
+void SpriteBatch::binSprites(uint16_t numBands) {
+    // helper function computes each sprite's screen rectangle once, and lists the sprites
+    // overlapping each band in z-order (counting sort: count, prefix sum, fill)
+    int matrixHeight = BitmapSprite::matrixHeight;
+    int matrixWidth = BitmapSprite::matrixWidth;
+
+    binStart.assign(numBands + 1, 0);
+    streamed = false;
+
+    for (Entry& entry : sprites) {
+        BitmapSprite& sprite = *entry.sprite;
+        entry.rect = sprite.bounds();
+        entry.alpha = sprite.alpha;
+        entry.blend = sprite.blend;
+        entry.image = sprite.image;
+        entry.colorChanges = sprite.colorChanges;
+        entry.frame = sprite.source();
+        entry.transformed = sprite.transformed;
+        entry.transform = sprite.transform;
+
+        // same checks as BitmapSprite::render(), done once per frame
+        bool visible = sprite.alpha != 0 && !sprite.loading && (sprite.image || sprite.stream) && sprite.wd != 0 && sprite.ht != 0;
+        if (!visible || entry.rect.right < entry.rect.left || entry.rect.bottom < 0 || entry.rect.top >= matrixHeight || entry.rect.right < 0 || entry.rect.left >= matrixWidth) {
+            entry.rect.bottom = entry.rect.top - 1; // mark as empty
+            continue;
+        }
+
+        if (sprite.stream) streamed = true; // the row cache is not thread-safe
+#if defined(BITMAPSPRITE_STATS)
+        sprite.countCall(entry.rect, {0, 0, matrixWidth - 1, matrixHeight - 1});
+#endif
+
+        int firstBand = max(entry.rect.top, 0) / bandHeight;
+        int lastBand = min(entry.rect.bottom, matrixHeight - 1) / bandHeight;
+        for (int band = firstBand; band <= lastBand; band++) binStart[band + 1]++;
+    }
+
+    for (uint16_t band = 0; band < numBands; band++) binStart[band + 1] += binStart[band];
+
+    bins.resize(binStart[numBands]);
+    std::vector<uint32_t> fill(binStart.begin(), binStart.end() - 1);
+
+    for (size_t i = 0; i < sprites.size(); i++) {
+        const BitmapSprite::Rect& rect = sprites[i].rect;
+        if (rect.bottom < rect.top) continue;
+
+        int firstBand = max(rect.top, 0) / bandHeight;
+        int lastBand = min(rect.bottom, matrixHeight - 1) / bandHeight;
+        for (int band = firstBand; band <= lastBand; band++) bins[fill[band]++] = i;
+    }
+}
+
+// render() and renderDirty() are compiled for each drawing buffer pixel type
+template void SpriteBatch::render<rgb16>(rgb16* buffer);
+template void SpriteBatch::render<rgb24>(rgb24* buffer);
+template void SpriteBatch::render<rgb48>(rgb48* buffer);
+template void SpriteBatch::render<linear48>(linear48* buffer);
+template const std::vector<BitmapSprite::Rect>& SpriteBatch::renderDirty<rgb16>(rgb16* buffer, const rgb16* background);
+template const std::vector<BitmapSprite::Rect>& SpriteBatch::renderDirty<rgb24>(rgb24* buffer, const rgb24* background);
+template const std::vector<BitmapSprite::Rect>& SpriteBatch::renderDirty<rgb48>(rgb48* buffer, const rgb48* background);
+template const std::vector<BitmapSprite::Rect>& SpriteBatch::renderDirty<linear48>(linear48* buffer, const linear48* background);
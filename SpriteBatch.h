@@ -0,0 +1,94 @@
+/*
+    SpriteBatch Class for use with BitmapSprite.
+
+    Renders many sprites per frame in one pass over the drawing buffer. Sprites are submitted in z-order,
+    binned into horizontal bands of the display, and each band is composited completely, for all of its
+    sprites, while it is hot in the cache.
+
+    renderDirty() redraws only the parts of the display that changed since the previous frame, over a
+    cached background image.
+
+    setOcclusion() culls the parts of sprites hidden behind opaque sprites: going front to back, each band
+    records which columns the opaque sprites cover, as spans, then draws the sprites back to front as usual,
+    leaving out the covered parts, so hidden pixels are never decoded. The output is the same.
+
+    With BITMAPSPRITE_THREADS defined (host builds, see CMakeLists.txt), setThreads() lets render() composite
+    the bands on several cores. Each band still draws its sprites in z-order, so the output is the same.
+*/
+
+#ifndef SpriteBatch_h
+#define SpriteBatch_h
+
+#include "BitmapSprite.h"
+
+#include <type_traits>
+#include <vector>
+#if defined(BITMAPSPRITE_THREADS)
+#include <memory>
+#endif
+
+class SpriteBatch {
+    public:
+        SpriteBatch(uint16_t bandHeight = 8);
+
+        void clear();
+        void add(BitmapSprite& sprite);
+        // the drawing buffer holds rgb16, rgb24, rgb48 or linear48 pixels, like for BitmapSprite::render()
+        template <typename P>
+        void render(P* buffer);
+        // background does not take part in deducing P, so it can be nullptr
+        template <typename P>
+        const std::vector<BitmapSprite::Rect>& renderDirty(P* buffer, const typename std::decay<P>::type* background);
+        void invalidate();
+        void setOcclusion(bool enabled) { occlusion = enabled; };
+        size_t size() { return sprites.size(); };
+#if defined(BITMAPSPRITE_THREADS)
+        void setThreads(uint count);
+        uint threads();
+#endif
+
+    private:
+        struct Entry {
+            BitmapSprite* sprite = nullptr;
+            BitmapSprite::Rect rect = {0, 0, -1, -1}; // screen rectangle, empty if the sprite is not drawn
+            uint8_t alpha = 0; // sprite state the frame was drawn with, to detect changes
+            BitmapSprite::BlendMode blend = BitmapSprite::BLEND_OVER;
+            const uint8_t* image = nullptr;
+            uint32_t colorChanges = 0; // see BitmapSprite::setPalette and setColorTransform
+            BitmapSprite::Rect frame = {0, 0, -1, -1}; // image rectangle drawn
+            bool transformed = false;
+            BitmapSprite::Transform transform;
+        };
+
+        uint16_t bandHeight;
+        bool occlusion = false; // leave out the parts of sprites hidden behind opaque ones (see setOcclusion)
+        bool streamed = false; // a visible sprite reads from the SD card: render on one thread
+        std::vector<Entry> sprites; // sprites of this frame, in z-order
+        std::vector<uint32_t> bins; // sprite indices for each band, in z-order
+        std::vector<uint32_t> binStart; // start of each band in bins
+
+        std::vector<Entry> previous; // sprites of the last frame drawn by renderDirty
+        std::vector<BitmapSprite::Rect> dirty;
+        bool fullRedraw = true;
+        uint16_t previousWidth = 0;
+        uint16_t previousHeight = 0;
+
+#if defined(BITMAPSPRITE_THREADS)
+        class Workers;
+        std::shared_ptr<Workers> workers; // threads besides the caller's, if any
+#endif
+
+        void binSprites(uint16_t numBands);
+        template <typename P>
+        void renderRect(P* buffer, const BitmapSprite::Rect& clip);
+        template <typename P>
+        void renderBand(P* buffer, const BitmapSprite::Rect& rect, int band);
+        template <typename P>
+        void renderOccluded(P* buffer, const BitmapSprite::Rect& clip, int band);
+        struct Scratch; // working memory of renderOccluded(), per thread
+        void addDirty(const BitmapSprite::Rect& rect);
+        void mergeDirty();
+        static bool sameTransform(const Entry& a, const Entry& b);
+};
+
+#endif
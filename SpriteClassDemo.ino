@@ -3,12 +3,14 @@
 #include "MatrixHardware_Teensy4_ShieldV5.h"
 
 #include "BitmapSprite.h"
+#include "SpriteBatch.h"
+#include "AssetCache.h"
 #include <SD.h>
 
 #include <SmartMatrix.h>
 
 // SmartMatrix setup parameters
-#define COLOR_DEPTH 24                  // known working: 24, 48 - If the sketch uses type `rgb24` directly, COLOR_DEPTH must be 24
+#define COLOR_DEPTH 24                  // known working: 24, 48 - sprites render into either buffer type
 const uint16_t kMatrixWidth = 128;
 const uint16_t kMatrixHeight = 64;
 const uint8_t kRefreshDepth = 30;       // known working: 24, 36, 48
@@ -24,6 +26,7 @@ SMARTMATRIX_ALLOCATE_BACKGROUND_LAYER(backgroundLayer, kMatrixWidth, kMatrixHeig
 
 #define NUMSPRITES 50
 BitmapSprite sprites[NUMSPRITES];
+SpriteBatch spriteBatch;
 
 int spriteXhome[NUMSPRITES];
 int spriteYhome[NUMSPRITES];
@@ -56,6 +59,10 @@ void setup() {
     /* Alternatively: Allocate sprite memory dynamically as needed */
     // sprites[0] = BitmapSprite("heart.bmp");
 
+    /* Or: Load through a cache that reads each file only once, within a memory budget */
+    // static AssetCache assets(64 * 1024);
+    // sprites[0] = assets.get("heart.bmp");
+
     for (int i = 0; i < NUMSPRITES; i++) {
         // Copy the first sprite to create multiple independent sprites that all use the same image
         // Note: doing this does not allocate more memory 
@@ -74,24 +81,45 @@ void setup() {
 
 void loop() {
 
-    // Get the drawing buffer pointer
-    rgb24* matrixBuffer = backgroundLayer.backBuffer();
+    // Get the drawing buffer pointer (rgb24* or rgb48*, depending on COLOR_DEPTH)
+    auto* matrixBuffer = backgroundLayer.backBuffer();
 
     // Clear screen
-    memset(matrixBuffer, 0, kMatrixHeight * kMatrixWidth * sizeof(rgb24));
+    memset(matrixBuffer, 0, kMatrixHeight * kMatrixWidth * sizeof(*matrixBuffer));
 
     uint period = 4000;
     float fraction = ((float)(millis() % period)) / ((float)period);
 
+    spriteBatch.clear();
     for (int i = 0; i < NUMSPRITES; i++) {
         // Compute sprite motion and fade
         sprites[i].x = spriteXhome[i] + roundf(spriteXampl[i] * cosf(6.2831853F * (fraction + spriteXphase[i])));
         sprites[i].y = spriteYhome[i] + roundf(spriteYampl[i] * cosf(6.2831853F * (fraction + spriteYphase[i])));
         sprites[i].alpha = roundf((255 + 255 * cosf(6.2831853F * (fraction + spriteAphase[i]))) / 2);
 
-        // Render sprite to drawing buffer
-        sprites[i].render(matrixBuffer);
+        /* Alternatively: move in sub-pixel steps while spinning, antialiased (x and y are then ignored) */
+        // sprites[i].transformed = true;
+        // sprites[i].transform.x = (spriteXhome[i] + spriteXampl[i] * cosf(6.2831853F * (fraction + spriteXphase[i]))) * 65536;
+        // sprites[i].transform.y = (spriteYhome[i] + spriteYampl[i] * cosf(6.2831853F * (fraction + spriteYphase[i]))) * 65536;
+        // sprites[i].transform.angle = (fraction + spriteAphase[i]) * 65536;
+        // sprites[i].transform.bilinear = true;
+
+        // Queue sprite for rendering, in front of the previous ones
+        spriteBatch.add(sprites[i]);
+    }
+
+    // Render all sprites to drawing buffer, band by band
+    spriteBatch.render(matrixBuffer);
+
+#if defined(BITMAPSPRITE_STATS)
+    // Print the rendering work of the last frame about once a second (see BitmapSprite.h)
+    static uint32_t lastStats = 0;
+    if (millis() - lastStats >= 1000) {
+        BitmapSprite::printStats();
+        lastStats = millis();
     }
+    BitmapSprite::resetStats();
+#endif
 
     backgroundLayer.swapBuffers(false);
 }
@@ -0,0 +1,96 @@
+/*
+    Offline converter from BMP files to pre-baked BitmapSprite images, built on the host (see CMakeLists.txt).
+
+    Each image is loaded as the sprite would load it, in the chosen load mode and with the chosen atlas frames,
+    then written with BitmapSprite::bake(). Copy the .spr files to the SD card and load them like BMP files,
+    or use them in place with BitmapSprite::loadBaked(): they are ready to render as soon as they are read.
+
+    Usage: bitmapsprite_bake [--mode bmp|rgb24a|linear] [--grid WxH[xCOUNT]] [-o output] input.bmp...
+      --mode    load mode to bake: bmp keeps the file's pixel format (smallest), rgb24a and linear are
+                converted and render fastest (default: bmp)
+      --grid    divide each image into frames of W x H pixels, optionally only the first COUNT
+      -o        output file, for a single input (default: the input with its extension replaced by .spr)
+*/
+
+#include "BitmapSprite.h"
+#include <SD.h>
+
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+static const char* sdPath(const std::string& path) {
+    // helper function points the SD stand-in at the file system root for absolute paths,
+    // and at the current directory for relative ones
+    SD.setRoot(path.size() && path[0] == '/' ? "/" : ".");
+    return path.c_str();
+}
+
+static std::string bakedName(const std::string& input) {
+    size_t dot = input.find_last_of('.');
+    size_t slash = input.find_last_of('/');
+    if (dot == std::string::npos || (slash != std::string::npos && dot < slash)) return input + ".spr";
+    return input.substr(0, dot) + ".spr";
+}
+
+static int usage() {
+    fprintf(stderr, "usage: bitmapsprite_bake [--mode bmp|rgb24a|linear] [--grid WxH[xCOUNT]] [-o output] input.bmp...\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    BitmapSprite::LoadMode mode = BitmapSprite::LOAD_BMP;
+    unsigned frameWidth = 0, frameHeight = 0, frameCount = 0;
+    std::string output;
+    std::vector<std::string> inputs;
+
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--mode" && i + 1 < argc) {
+            std::string name = argv[++i];
+            if (name == "bmp") mode = BitmapSprite::LOAD_BMP;
+            else if (name == "rgb24a") mode = BitmapSprite::LOAD_RGB24A;
+            else if (name == "linear") mode = BitmapSprite::LOAD_LINEAR;
+            else return usage();
+        } else if (arg == "--grid" && i + 1 < argc) {
+            if (sscanf(argv[++i], "%ux%ux%u", &frameWidth, &frameHeight, &frameCount) < 2) return usage();
+        } else if (arg == "-o" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg.size() > 1 && arg[0] == '-') {
+            return usage();
+        } else {
+            inputs.push_back(arg);
+        }
+    }
+    if (inputs.empty() || (output.size() && inputs.size() > 1)) return usage();
+
+    int failures = 0;
+    for (const std::string& input : inputs) {
+        BitmapSprite sprite(sdPath(input), mode);
+        if (sprite.loadStatus() != BitmapSprite::LOAD_READY) {
+            fprintf(stderr, "%s: could not load\n", input.c_str());
+            failures++;
+            continue;
+        }
+        if (frameWidth && !sprite.setFrameGrid(frameWidth, frameHeight, frameCount)) {
+            fprintf(stderr, "%s: frame grid does not fit\n", input.c_str());
+            failures++;
+            continue;
+        }
+
+        std::string baked = output.size() ? output : bakedName(input);
+        if (!sprite.bake(sdPath(baked))) {
+            fprintf(stderr, "%s: could not write %s\n", input.c_str(), baked.c_str());
+            failures++;
+            continue;
+        }
+        if (sprite.frameCount()) {
+            printf("%s -> %s (%u frames of %ux%u, %zu bytes)\n", input.c_str(), baked.c_str(),
+                   sprite.frameCount(), sprite.width(), sprite.height(), sprite.memoryUsed());
+        } else {
+            printf("%s -> %s (%ux%u, %zu bytes)\n", input.c_str(), baked.c_str(), sprite.width(), sprite.height(), sprite.memoryUsed());
+        }
+    }
+    return failures ? 1 : 0;
+}
@@ -0,0 +1,1073 @@
+/*
+    Render benchmark for BitmapSprite, built on the host (see CMakeLists.txt).
+
+    Generates BMP files in every supported format, renders them at several sizes, clipping
+    positions and sprite alphas, and reports ns/pixel and how many sprites fit in a 60 Hz frame.
+    Scene cases render many sprites per frame, one render() call each, through a SpriteBatch (also on all
+    cores), and through a LinearBuffer, and redraw only what changed when a few of them move (SpriteBatch::renderDirty).
+    Stack cases draw overlapping opaque panels under translucent icons, with and without occlusion. Scroll cases pan and
+    tilt over images much larger than the display, held in memory or streamed (LOAD_STREAM).
+    Load cases compare a blocking load with incremental loading and pre-baked images, dest cases render into rgb16,
+    rgb24 and rgb48 drawing buffers, affine cases place, rotate and scale a sprite with a transform, and palette
+    cases recolor an indexed sprite on every frame (setPalette). Color cases tint sprites and pass them through a
+    color matrix (setColorTransform). Blend cases draw sprites with each blend mode. Collide cases test sprites against each other
+    and against points (collidesWith, hitTest); for them, sprites/frame is the number of tests per frame. Text cases
+    scroll a long ticker across the display, drawn with one sprite per character and with a BitmapFont.
+    Built with BITMAPSPRITE_STATS, it also prints the work done by all cases, by image format; the counters
+    slow the kernels down, so compare timings only between builds without them.
+
+    The check cases time nothing: they render every format, load mode and drawing buffer type, also tinted,
+    through a color matrix, with a swapped palette and with each blend mode, and a SpriteBatch, once over a
+    fixed background, and hash the buffers, to compare the output of two builds. The bench_verify target
+    (see CMakeLists.txt) compares the configured blend path with plain C (BITMAPSPRITE_SCALAR_BLEND). They
+    also compare SpriteBatch renders with occlusion and on worker threads with the serial render, within
+    one build.
+
+    Usage: bitmapsprite_bench [--quick] [--csv] [filter]
+           bitmapsprite_bench --digest FILE | --verify FILE [filter]
+      --quick   shorter timing runs
+      --csv     machine-readable output, for regression tracking
+      --digest  write the hashes of the check cases to FILE
+      --verify  compare the check cases with the hashes in FILE, exit status 1 if any differ
+      filter    only run cases whose name contains this string
+*/
+
+#include "BitmapSprite.h"
+#include "SpriteBatch.h"
+#include "LinearBuffer.h"
+#include "BitmapFont.h"
+#include <SD.h>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#if defined(BITMAPSPRITE_THREADS)
+#include <thread>
+#endif
+
+static const uint16_t kMatrixWidth = 128;
+static const uint16_t kMatrixHeight = 64;
+
+struct BmpFormat {
+    const char* name;
+    int bitspp;
+    int compression; // 0 = none, 1 = RLE8, 2 = RLE4, 3 = bitfields
+    uint32_t rMask, gMask, bMask, aMask;
+    int headerSize;
+    bool alpha; // fill the alpha bits (in the mask, or the unused MSBs)
+};
+
+static const BmpFormat formats[] = {
+    {"rgb1", 1, 0, 0, 0, 0, 0, 40, false},
+    {"rgb4", 4, 0, 0, 0, 0, 0, 40, false},
+    {"rgb8", 8, 0, 0, 0, 0, 0, 40, false},
+    {"rgb555", 16, 0, 0, 0, 0, 0, 40, false},
+    {"rgb565", 16, 3, 0xF800, 0x07E0, 0x001F, 0, 40, false},
+    {"argb1555", 16, 3, 0x7C00, 0x03E0, 0x001F, 0x8000, 108, true},
+    {"rgb24", 24, 0, 0, 0, 0, 0, 40, false},
+    {"xrgb32", 32, 0, 0, 0, 0, 0, 40, false},
+    {"argb32", 32, 3, 0x00FF0000, 0x0000FF00, 0x000000FF, 0xFF000000, 108, true},
+    {"rgba32", 32, 3, 0xFF000000, 0x00FF0000, 0x0000FF00, 0x000000FF, 108, true},
+    {"rle8", 8, 1, 0, 0, 0, 0, 40, false},
+    {"rle4", 4, 2, 0, 0, 0, 0, 40, false},
+};
+
+static void put16(std::vector<uint8_t>& v, size_t pos, uint32_t val) {
+    v[pos] = val;
+    v[pos + 1] = val >> 8;
+}
+
+static void put32(std::vector<uint8_t>& v, size_t pos, uint32_t val) {
+    for (int i = 0; i < 4; i++) v[pos + i] = val >> (8 * i);
+}
+
+static std::vector<uint8_t> encodeRLE(const BmpFormat& f, int width, int height, std::mt19937& rng) {
+    // Builds RLE data for a round sprite of color runs, like flat-shaded artwork:
+    // transparent corners are skipped with delta escapes.
+    std::vector<uint8_t> data;
+    float radius = 0.5f * width;
+
+    for (int j = 0; j < height; j++) {
+        float dy = j + 0.5f - 0.5f * height;
+        float half = radius * radius - dy * dy;
+        int x0 = half > 0 ? (int)(0.5f * width - sqrtf(half) + 0.5f) : width;
+        int x1 = half > 0 ? (int)(0.5f * width + sqrtf(half) + 0.5f) : width;
+        for (int x = x0; x > 0;) { // delta escapes move at most 255 columns
+            int dx = std::min(x, 255);
+            data.insert(data.end(), {0, 2, (uint8_t)dx, 0});
+            x -= dx;
+        }
+        for (int x = x0; x < x1;) {
+            int run = std::min(x1 - x, 4 + (int)(rng() % 21));
+            uint8_t color = rng() % (1 << f.bitspp);
+            data.push_back(run);
+            data.push_back(f.compression == 2 ? color * 17 : color); // RLE4: same index in both nibbles
+            x += run;
+        }
+        data.insert(data.end(), {0, 0}); // end of line
+    }
+    data.insert(data.end(), {0, 1}); // end of bitmap
+    return data;
+}
+
+static std::vector<uint8_t> makeBitmap(const BmpFormat& f, int width, int height) {
+    // Builds a bottom-up BMP with random colors. Alpha formats get a round sprite:
+    // opaque center, translucent edge, transparent corners. RLE formats get a round sprite of color runs.
+    std::mt19937 rng(width * 131 + f.bitspp);
+    int rowBytes = ((width * f.bitspp + 31) / 32) * 4;
+    int colors = f.bitspp <= 8 ? (1 << f.bitspp) : 0;
+    int masks = (f.compression == 3 && f.headerSize == 40) ? 12 : 0;
+    size_t dataOffset = 14 + f.headerSize + masks + colors * 4;
+    bool rle = f.compression == 1 || f.compression == 2;
+    std::vector<uint8_t> rleData;
+    if (rle) rleData = encodeRLE(f, width, height, rng);
+    size_t imageSize = rle ? rleData.size() : rowBytes * height;
+
+    std::vector<uint8_t> v(dataOffset + imageSize);
+    v[0] = 'B';
+    v[1] = 'M';
+    put32(v, 2, v.size());
+    put32(v, 10, dataOffset);
+    put32(v, 14, f.headerSize);
+    put32(v, 18, width);
+    put32(v, 22, height);
+    put16(v, 26, 1);
+    put16(v, 28, f.bitspp);
+    put32(v, 30, f.compression);
+    put32(v, 34, imageSize);
+    if (f.compression == 3) {
+        put32(v, 54, f.rMask);
+        put32(v, 58, f.gMask);
+        put32(v, 62, f.bMask);
+        if (f.headerSize > 52) put32(v, 66, f.aMask);
+    }
+    for (int i = 0; i < colors * 4; i++) v[14 + f.headerSize + i] = rng();
+
+    uint8_t* image = v.data() + dataOffset;
+    if (rle) {
+        std::copy(rleData.begin(), rleData.end(), image);
+        return v;
+    }
+    uint32_t aMask = f.aMask ? f.aMask : 0xFF000000;
+    float radius = 0.5f * width;
+
+    for (int j = 0; j < height; j++) {
+        uint8_t* rowPtr = image + j * rowBytes;
+        for (int i = 0; i < rowBytes; i++) rowPtr[i] = rng();
+        if (!(f.bitspp == 32 || f.bitspp == 16)) continue;
+
+        for (int i = 0; i < width; i++) {
+            int bytes = f.bitspp / 8;
+            uint32_t pixWord = 0;
+            for (int k = 0; k < bytes; k++) pixWord |= rowPtr[i * bytes + k] << (8 * k);
+            pixWord &= ~(f.alpha ? aMask : (bytes == 2 ? 0x8000 : 0xFF000000));
+            if (f.alpha) {
+                float dx = i + 0.5f - 0.5f * width, dy = j + 0.5f - 0.5f * height;
+                float d = radius - sqrtf(dx * dx + dy * dy);
+                uint32_t a = d <= 0 ? 0 : d >= 2 ? 255 : (uint32_t)(d * 127);
+                pixWord |= ((uint64_t)a * aMask / 255) & aMask;
+            }
+            for (int k = 0; k < bytes; k++) rowPtr[i * bytes + k] = pixWord >> (8 * k);
+        }
+    }
+    return v;
+}
+
+static void writeBitmap(const char* name, const std::vector<uint8_t>& bytes) {
+    // Writes a bitmap file to the SD card, for the sprites to load
+    File file = SD.open(name, FILE_WRITE);
+    file.write(bytes.data(), bytes.size());
+    file.close();
+}
+
+struct Result {
+    std::string name;
+    double nsPerCall;
+    double nsPerPixel;
+    double spritesPerFrame;
+};
+
+template <typename Fn>
+static double timeCalls(Fn fn, double minSeconds) {
+    // returns ns per call of fn, repeating until minSeconds have elapsed
+    typedef std::chrono::steady_clock clock;
+    long calls = 0;
+    long batch = 16;
+    clock::time_point start = clock::now();
+    double elapsed = 0;
+    while (elapsed < minSeconds) {
+        for (long i = 0; i < batch; i++) fn();
+        calls += batch;
+        batch *= 2;
+        elapsed = std::chrono::duration<double>(clock::now() - start).count();
+    }
+    return elapsed * 1e9 / calls;
+}
+
+static double timeRenders(BitmapSprite& sprite, std::vector<rgb24>& buffer, double minSeconds) {
+    // returns ns per render() call
+    return timeCalls([&]() { sprite.render(buffer.data()); }, minSeconds);
+}
+
+static void benchScenes(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // many 16x16 round sprites scattered over the display, drawn one by one and as a batch
+    struct Scene {
+        uint16_t width;
+        uint16_t height;
+        int count;
+    };
+    const Scene scenes[] = {{128, 64, 200}, {512, 256, 2000}};
+
+    writeBitmap("bench.bmp", makeBitmap(formats[8], 16, 16)); // argb32
+    BitmapSprite master("bench.bmp", BitmapSprite::LOAD_RGB24A);
+
+    for (const Scene& scene : scenes) {
+        BitmapSprite::setDisplaySize(scene.width, scene.height);
+        std::vector<rgb24> buffer(scene.width * scene.height, rgb24(40, 80, 120));
+
+        std::mt19937 rng(1);
+        std::vector<BitmapSprite> sprites(scene.count, master); // copies share the image data
+        for (BitmapSprite& sprite : sprites) {
+            sprite.x = (int)(rng() % (scene.width + 16)) - 16;
+            sprite.y = (int)(rng() % (scene.height + 16));
+        }
+
+        const char* variants[] = {"single", "batch", "dirty", "linear", "threads"};
+        for (int variant = 0; variant < 5; variant++) {
+            char name[96];
+            snprintf(name, sizeof(name), "scene/%dx%d/%d/%s", scene.width, scene.height, scene.count, variants[variant]);
+#if defined(BITMAPSPRITE_THREADS)
+            uint threads = std::max(std::thread::hardware_concurrency(), 1u);
+            if (variant == 4) snprintf(name, sizeof(name), "scene/%dx%d/%d/threads%u", scene.width, scene.height, scene.count, threads);
+#else
+            if (variant == 4) continue;
+#endif
+            if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+            double ns;
+            if (variant == 4) {
+#if defined(BITMAPSPRITE_THREADS)
+                // the batch, with bands composited on every core
+                SpriteBatch batch;
+                batch.setThreads(threads);
+                ns = timeCalls([&]() {
+                    batch.clear();
+                    for (BitmapSprite& sprite : sprites) batch.add(sprite);
+                    batch.render(buffer.data());
+                }, minSeconds);
+#endif
+            } else if (variant == 3) {
+                // blend into a 16-bit linear buffer, then gamma-encode each pixel once
+                LinearBuffer accum;
+                SpriteBatch batch;
+                ns = timeCalls([&]() {
+                    accum.clear();
+                    batch.clear();
+                    for (BitmapSprite& sprite : sprites) batch.add(sprite);
+                    batch.render(accum.buffer());
+                    accum.encode(buffer.data());
+                }, minSeconds);
+            } else if (variant == 2) {
+                // mostly static content: 1% of the sprites move by one pixel per frame
+                std::vector<rgb24> background(buffer);
+                SpriteBatch batch;
+                int frame = 0;
+                ns = timeCalls([&]() {
+                    int step = (frame++ & 1) ? 1 : -1;
+                    for (int i = 0; i < scene.count; i += 100) sprites[i].x += step;
+                    batch.clear();
+                    for (BitmapSprite& sprite : sprites) batch.add(sprite);
+                    batch.renderDirty(buffer.data(), background.data());
+                }, minSeconds);
+            } else if (variant == 1) {
+                SpriteBatch batch;
+                ns = timeCalls([&]() {
+                    batch.clear();
+                    for (BitmapSprite& sprite : sprites) batch.add(sprite);
+                    batch.render(buffer.data());
+                }, minSeconds);
+            } else {
+                ns = timeCalls([&]() {
+                    for (BitmapSprite& sprite : sprites) sprite.render(buffer.data());
+                }, minSeconds);
+            }
+
+            Result r;
+            r.name = name;
+            r.nsPerCall = ns / scene.count;
+            r.nsPerPixel = r.nsPerCall / (16 * 16);
+            r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+            results.push_back(r);
+        }
+    }
+    BitmapSprite::setDisplaySize(kMatrixWidth, kMatrixHeight);
+}
+
+static void benchStack(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // stacked opaque panels, as in a windowed UI, with translucent icons on top: drawn back to front by a
+    // batch, and with occlusion, so the hidden parts of the panels are never decoded. The panels are rgb565
+    // BMP files rendered as loaded, which convert every pixel they draw.
+    const int panelCount = 12;
+    const int iconCount = 40;
+
+    writeBitmap("bench.bmp", makeBitmap(formats[4], 48, 32)); // rgb565
+    BitmapSprite panel("bench.bmp", BitmapSprite::LOAD_BMP);
+
+    writeBitmap("bench.bmp", makeBitmap(formats[8], 16, 16)); // argb32
+    BitmapSprite icon("bench.bmp", BitmapSprite::LOAD_RGB24A);
+
+    std::mt19937 rng(1);
+    std::vector<BitmapSprite> sprites(panelCount, panel);
+    sprites.resize(panelCount + iconCount, icon);
+    for (BitmapSprite& sprite : sprites) {
+        sprite.x = (int)(rng() % (kMatrixWidth - 16));
+        sprite.y = (int)(rng() % (kMatrixHeight - 16)) + 16;
+    }
+    std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight, rgb24(40, 80, 120));
+
+    const char* variants[] = {"batch", "occlusion"};
+    for (int variant = 0; variant < 2; variant++) {
+        char name[96];
+        snprintf(name, sizeof(name), "stack/%dx%d/%d+%d/%s", kMatrixWidth, kMatrixHeight, panelCount, iconCount, variants[variant]);
+        if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+        SpriteBatch batch;
+        batch.setOcclusion(variant == 1);
+        double ns = timeCalls([&]() {
+            batch.clear();
+            for (BitmapSprite& sprite : sprites) batch.add(sprite);
+            batch.render(buffer.data());
+        }, minSeconds);
+
+        Result r;
+        r.name = name;
+        r.nsPerCall = ns / sprites.size();
+        r.nsPerPixel = ns / (kMatrixWidth * kMatrixHeight); // per display pixel
+        r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+        results.push_back(r);
+    }
+}
+
+static void benchScroll(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // scroll the display window one pixel per frame over a panorama and a tall banner, wrapping around
+    struct Image {
+        const char* name;
+        int width;
+        int height;
+    };
+    const Image images[] = {{"pan", 4096, kMatrixHeight}, {"tilt", kMatrixWidth, 4096}};
+    const int formatIndices[] = {4, 6, 8}; // rgb565, rgb24, argb32
+
+    for (const Image& image : images) {
+        for (int formatIndex : formatIndices) {
+            const BmpFormat& f = formats[formatIndex];
+            writeBitmap("bench.bmp", makeBitmap(f, image.width, image.height));
+
+            for (int streamed = 0; streamed < 2; streamed++) {
+                char name[96];
+                snprintf(name, sizeof(name), "scroll/%s/%dx%d/%s/%s", image.name, image.width, image.height, f.name, streamed ? "stream" : "bmp");
+                if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+                BitmapSprite sprite("bench.bmp", streamed ? BitmapSprite::LOAD_STREAM : BitmapSprite::LOAD_BMP);
+                std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight);
+                int step = 0;
+                double ns = timeCalls([&]() {
+                    // bottom-up bitmaps are placed by their bottom left corner
+                    int offset = step++ % (max(image.width - kMatrixWidth, image.height - kMatrixHeight) + 1);
+                    sprite.x = (image.width > kMatrixWidth) ? -offset : 0;
+                    sprite.y = (image.height > kMatrixHeight) ? image.height - 1 - offset : image.height - 1;
+                    sprite.render(buffer.data());
+                }, minSeconds);
+
+                Result r;
+                r.name = name;
+                r.nsPerCall = ns;
+                r.nsPerPixel = ns / (kMatrixWidth * kMatrixHeight);
+                r.spritesPerFrame = 1e9 / 60 / ns;
+                results.push_back(r);
+            }
+        }
+    }
+}
+
+static void benchLoad(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // loading a 512x256 argb32 image: all at once, and the longest single step of continueLoad(2048)
+    // the step time is what a frame has to spare while the image loads in the background;
+    // the smallest longest step over repeated loads is reported, to leave out scheduling noise.
+    // Pre-baked copies are loaded from a file, and used in place from a memory-mapped file
+    writeBitmap("bench.bmp", makeBitmap(formats[8], 512, 256));
+
+    const char* modeNames[] = {"bmp", "rgb24a", "linear"};
+    const char* variants[] = {"blocking", "step", "baked", "mapped"};
+    for (int mode = 0; mode < 3; mode++) {
+        BitmapSprite("bench.bmp", (BitmapSprite::LoadMode)mode).bake("bench.spr");
+
+        for (int variant = 0; variant < 4; variant++) {
+            char name[96];
+            snprintf(name, sizeof(name), "load/512x256/%s/%s", modeNames[mode], variants[variant]);
+            if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+            double ns;
+            if (variant == 3) {
+                ns = timeCalls([&]() {
+                    size_t size;
+                    const uint8_t* data = SD.map("bench.spr", size);
+                    BitmapSprite sprite;
+                    sprite.loadBaked(data, size);
+                    sprite = BitmapSprite();
+                    SD.unmap(data, size);
+                }, minSeconds);
+            } else if (variant == 2) {
+                ns = timeCalls([&]() {
+                    BitmapSprite sprite("bench.spr");
+                }, minSeconds);
+            } else if (variant == 1) {
+                typedef std::chrono::steady_clock clock;
+                ns = 1e18;
+                clock::time_point end = clock::now() + std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(minSeconds));
+                do {
+                    BitmapSprite sprite;
+                    sprite.beginLoad("bench.bmp", (BitmapSprite::LoadMode)mode);
+                    double longest = 0;
+                    while (sprite.loadStatus() == BitmapSprite::LOAD_PENDING) {
+                        clock::time_point start = clock::now();
+                        sprite.continueLoad(2048);
+                        longest = max(longest, std::chrono::duration<double, std::nano>(clock::now() - start).count());
+                    }
+                    ns = min(ns, longest);
+                } while (clock::now() < end);
+            } else {
+                ns = timeCalls([&]() {
+                    BitmapSprite sprite("bench.bmp", (BitmapSprite::LoadMode)mode);
+                }, minSeconds);
+            }
+
+            Result r;
+            r.name = name;
+            r.nsPerCall = ns;
+            r.nsPerPixel = ns / (512 * 256);
+            r.spritesPerFrame = 1e9 / 60 / ns;
+            results.push_back(r);
+        }
+    }
+    SD.remove("bench.spr");
+}
+
+template <typename P>
+static void benchDestType(const char* typeName, double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // helper function renders the benchmark sprite into a drawing buffer of pixel type P
+    const char* modeNames[] = {"bmp", "rgb24a", "linear"};
+    const uint8_t alphas[] = {128, 255};
+    std::vector<P> buffer(kMatrixWidth * kMatrixHeight, P());
+
+    for (int mode = 0; mode < 3; mode++) {
+        BitmapSprite sprite("bench.bmp", (BitmapSprite::LoadMode)mode);
+        sprite.x = 10;
+        sprite.y = 10 + 32 - 1;
+        for (uint8_t alpha : alphas) {
+            char name[96];
+            snprintf(name, sizeof(name), "dest/%s/argb32/32x32/%s/a%d", typeName, modeNames[mode], alpha);
+            if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+            sprite.alpha = alpha;
+            Result r;
+            r.name = name;
+            r.nsPerCall = timeCalls([&]() { sprite.render(buffer.data()); }, minSeconds);
+            r.nsPerPixel = r.nsPerCall / (32 * 32);
+            r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+            results.push_back(r);
+        }
+    }
+}
+
+static void benchDest(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // the same sprite rendered into each supported drawing buffer type
+    writeBitmap("bench.bmp", makeBitmap(formats[8], 32, 32)); // argb32
+
+    benchDestType<rgb16>("rgb16", minSeconds, filter, results);
+    benchDestType<rgb24>("rgb24", minSeconds, filter, results);
+    benchDestType<rgb48>("rgb48", minSeconds, filter, results);
+}
+
+static void benchAffine(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // a transformed sprite, compared with the plain render of the dest cases
+    struct Variant {
+        const char* name;
+        int32_t scale;
+        uint16_t angle;
+        bool bilinear;
+    };
+    const Variant variants[] = {
+        {"subpixel", 0x10000, 0, false},
+        {"rotate", 0x10000, 5461, false}, // 30 degrees
+        {"scale2x", 0x20000, 0, false},
+        {"bilinear", 0x10000, 0, true},
+        {"bilinear-rot", 0x10000, 5461, true},
+    };
+    const char* modeNames[] = {"bmp", "rgb24a", "linear"};
+    std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight, rgb24(40, 80, 120));
+
+    for (int mode = 0; mode < 3; mode++) {
+        BitmapSprite sprite("bench.bmp", (BitmapSprite::LoadMode)mode);
+        sprite.transformed = true;
+        for (const Variant& v : variants) {
+            char name[96];
+            snprintf(name, sizeof(name), "affine/argb32/32x32/%s/%s", modeNames[mode], v.name);
+            if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+            sprite.transform.x = (48 << 16) + 0x4000; // a quarter pixel off the grid
+            sprite.transform.y = (32 << 16) + 0x4000;
+            sprite.transform.scaleX = v.scale;
+            sprite.transform.scaleY = v.scale;
+            sprite.transform.angle = v.angle;
+            sprite.transform.bilinear = v.bilinear;
+            double area = 32.0 * 32 * v.scale / 0x10000 * v.scale / 0x10000;
+
+            Result r;
+            r.name = name;
+            r.nsPerCall = timeRenders(sprite, buffer, minSeconds);
+            r.nsPerPixel = r.nsPerCall / area;
+            r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+            results.push_back(r);
+        }
+    }
+}
+
+static void benchPalette(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // an indexed sprite with its own colors, and recolored before every render, as for palette cycling
+    writeBitmap("bench.bmp", makeBitmap(formats[2], 32, 32)); // rgb8
+
+    const char* variants[] = {"image", "cycle"};
+    const uint8_t alphas[] = {128, 255};
+    std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight, rgb24(40, 80, 120));
+    std::vector<rgb24> colors(256);
+    for (int i = 0; i < 256; i++) colors[i] = rgb24(i, 255 - i, i * 7);
+
+    BitmapSprite sprite("bench.bmp");
+    sprite.x = 10;
+    sprite.y = 10 + 32 - 1;
+    for (int variant = 0; variant < 2; variant++) {
+        for (uint8_t alpha : alphas) {
+            char name[96];
+            snprintf(name, sizeof(name), "palette/rgb8/32x32/%s/a%d", variants[variant], alpha);
+            if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+            sprite.alpha = alpha;
+            Result r;
+            r.name = name;
+            r.nsPerCall = timeCalls([&]() {
+                if (variant == 1) {
+                    std::rotate(colors.begin(), colors.begin() + 1, colors.end());
+                    sprite.setPalette(colors.data(), 256);
+                }
+                sprite.render(buffer.data());
+            }, minSeconds);
+            r.nsPerPixel = r.nsPerCall / (32 * 32);
+            r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+            results.push_back(r);
+        }
+    }
+}
+
+static void benchColor(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // sprites drawn in their own colors, tinted, and through a full color matrix (setColorTransform);
+    // indexed images map their palette once, other formats map each pixel
+    struct Variant {
+        const char* name;
+        bool mapped;
+        BitmapSprite::ColorTransform transform;
+    };
+    const Variant variants[] = {
+        {"plain", false, BitmapSprite::ColorTransform()},
+        {"tint", true, BitmapSprite::ColorTransform::tint(255, 160, 64)},
+        {"matrix", true, BitmapSprite::ColorTransform::saturation(128).then(BitmapSprite::ColorTransform::brightness(300, 8))},
+    };
+    const int formatIndex[] = {2, 8}; // rgb8, argb32
+    const char* modeNames[] = {"bmp", "rgb24a", "linear"};
+    const uint8_t alphas[] = {128, 255};
+    std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight, rgb24(40, 80, 120));
+
+    for (int fi : formatIndex) {
+        const BmpFormat& f = formats[fi];
+        writeBitmap("bench.bmp", makeBitmap(f, 32, 32));
+
+        for (int mode = 0; mode < 3; mode++) {
+            if (fi == 2 && mode != 0) continue; // the converting modes drop the palette
+            BitmapSprite sprite("bench.bmp", (BitmapSprite::LoadMode)mode);
+            sprite.x = 10;
+            sprite.y = 10 + 32 - 1;
+            for (const Variant& v : variants) {
+                for (uint8_t alpha : alphas) {
+                    char name[96];
+                    snprintf(name, sizeof(name), "color/%s/32x32/%s/%s/a%d", f.name, modeNames[mode], v.name, alpha);
+                    if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+                    if (v.mapped) {
+                        sprite.setColorTransform(v.transform);
+                    } else {
+                        sprite.resetColorTransform();
+                    }
+                    sprite.alpha = alpha;
+                    Result r;
+                    r.name = name;
+                    r.nsPerCall = timeRenders(sprite, buffer, minSeconds);
+                    r.nsPerPixel = r.nsPerCall / (32 * 32);
+                    r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+                    results.push_back(r);
+                }
+            }
+        }
+    }
+}
+
+static void benchBlend(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // sprites drawn with each blend mode, compared with source-over
+    const BitmapSprite::BlendMode modes[] = {BitmapSprite::BLEND_OVER, BitmapSprite::BLEND_ADD, BitmapSprite::BLEND_MULTIPLY,
+        BitmapSprite::BLEND_SCREEN, BitmapSprite::BLEND_REPLACE};
+    const char* modeNames[] = {"over", "add", "multiply", "screen", "replace"};
+    const char* loadNames[] = {"bmp", "rgb24a"};
+    const int formatIndex[] = {8, 10}; // argb32, rle8
+    const uint8_t alphas[] = {128, 255};
+    std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight, rgb24(40, 80, 120));
+
+    for (int fi : formatIndex) {
+        const BmpFormat& f = formats[fi];
+        writeBitmap("bench.bmp", makeBitmap(f, 32, 32));
+
+        for (int load = 0; load < 2; load++) {
+            BitmapSprite sprite("bench.bmp", (BitmapSprite::LoadMode)load);
+            sprite.x = 10;
+            sprite.y = 10 + 32 - 1;
+            for (int mode = 0; mode < 5; mode++) {
+                for (uint8_t alpha : alphas) {
+                    char name[96];
+                    snprintf(name, sizeof(name), "blend/%s/32x32/%s/%s/a%d", f.name, loadNames[load], modeNames[mode], alpha);
+                    if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+                    sprite.blend = modes[mode];
+                    sprite.alpha = alpha;
+                    Result r;
+                    r.name = name;
+                    r.nsPerCall = timeRenders(sprite, buffer, minSeconds);
+                    r.nsPerPixel = r.nsPerCall / (32 * 32);
+                    r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+                    results.push_back(r);
+                }
+            }
+        }
+    }
+}
+
+static void benchCollide(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // 16x16 round sprites scattered over the display: every pair is tested, and each sprite against a point
+    writeBitmap("bench.bmp", makeBitmap(formats[8], 16, 16)); // argb32
+    BitmapSprite master("bench.bmp");
+
+    const int count = 200;
+    std::mt19937 rng(1);
+    std::vector<BitmapSprite> sprites(count, master);
+    for (BitmapSprite& sprite : sprites) {
+        sprite.x = (int)(rng() % (kMatrixWidth + 16)) - 16;
+        sprite.y = (int)(rng() % (kMatrixHeight + 16));
+    }
+
+    const char* variants[] = {"pairs", "rotated", "point"};
+    for (int variant = 0; variant < 3; variant++) {
+        char name[96];
+        snprintf(name, sizeof(name), "collide/argb32/16x16/%d/%s", count, variants[variant]);
+        if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+        for (int i = 0; i < count; i++) {
+            BitmapSprite& sprite = sprites[i];
+            sprite.transformed = variant == 1;
+            sprite.transform.x = (sprite.x + 8) << 16;
+            sprite.transform.y = (sprite.y - 8) << 16;
+            sprite.transform.angle = i * 997;
+        }
+
+        long tests = (variant == 2) ? count : count * (count - 1) / 2;
+        int hits = 0;
+        double ns = timeCalls([&]() {
+            for (int i = 0; i < count; i++) {
+                if (variant == 2) {
+                    hits += sprites[i].hitTest(kMatrixWidth / 2, kMatrixHeight / 2);
+                } else {
+                    for (int j = i + 1; j < count; j++) hits += sprites[i].collidesWith(sprites[j]);
+                }
+            }
+        }, minSeconds);
+
+        Result r;
+        r.name = name;
+        r.nsPerCall = ns / tests;
+        r.nsPerPixel = 0;
+        r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+        results.push_back(r);
+    }
+}
+
+static void benchText(double minSeconds, const std::string& filter, std::vector<Result>& results) {
+    // a 200 character ticker scrolling one pixel per frame, from a 1bpp sheet of 8x8 glyphs: one sprite per
+    // character (atlas frames of the sheet), and one BitmapFont::render() call for the whole string
+    const int length = 200;
+    std::vector<uint8_t> bmp = makeBitmap(formats[0], 16 * 8, 6 * 8); // rgb1
+    std::mt19937 rng(1);
+    uint32_t dataOffset = bmp[10] | (bmp[11] << 8);
+    for (size_t i = dataOffset; i < bmp.size(); i++) {
+        // glyph-like ink: sparse strokes, with a blank border around each cell
+        int row = (i - dataOffset) / 16;
+        bmp[i] = (row % 8 == 0 || row % 8 == 7) ? 0 : (rng() & rng() & 0x7E);
+    }
+    writeBitmap("bench.bmp", bmp);
+    BitmapSprite sheet("bench.bmp");
+    sheet.setFrameGrid(8, 8);
+    BitmapFont font;
+    font.load(sheet, 8, 8);
+
+    std::string text;
+    for (int i = 0; i < length; i++) text += (char)(' ' + (i * 37) % 95);
+    std::vector<BitmapSprite> glyphs(length, sheet);
+    std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight, rgb24(40, 80, 120));
+
+    const char* variants[] = {"sprites", "font"};
+    for (int variant = 0; variant < 2; variant++) {
+        char name[96];
+        snprintf(name, sizeof(name), "text/%dx%d/8x8/%d/%s", kMatrixWidth, kMatrixHeight, length, variants[variant]);
+        if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+        int scroll = 0;
+        double ns = timeCalls([&]() {
+            int x = kMatrixWidth - scroll;
+            scroll = (scroll + 1) % (length * 8 + kMatrixWidth);
+            if (variant == 1) {
+                font.render(buffer.data(), x, kMatrixHeight / 2, text.c_str(), rgb24(255, 200, 0));
+                return;
+            }
+            for (int i = 0; i < length; i++) {
+                BitmapSprite& glyph = glyphs[i];
+                glyph.frame = text[i] - ' ';
+                glyph.x = x + i * 8;
+                glyph.y = kMatrixHeight / 2 + 7; // placed by the bottom left corner
+                glyph.render(buffer.data());
+            }
+        }, minSeconds);
+
+        Result r;
+        r.name = name;
+        r.nsPerCall = ns;
+        r.nsPerPixel = ns / (kMatrixWidth * 8); // per pixel of the ticker line
+        r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+        results.push_back(r);
+    }
+}
+
+struct Digest {
+    std::string name;
+    uint64_t hash;
+};
+
+static uint64_t hashBytes(const void* data, size_t size) {
+    // FNV-1a, to compare rendered buffers between builds
+    const uint8_t* bytes = (const uint8_t*)data;
+    uint64_t h = 1469598103934665603ull;
+    for (size_t i = 0; i < size; i++) h = (h ^ bytes[i]) * 1099511628211ull;
+    return h;
+}
+
+// a background that differs in every pixel, so each blend reads a different destination color
+static void checkColor(rgb16& p, int x, int y) { p = rgb16(x & 31, y & 63, (x + y) & 31); }
+static void checkColor(rgb24& p, int x, int y) { p = rgb24(x * 2, y * 4, x + y); }
+static void checkColor(rgb48& p, int x, int y) { p = rgb48(x * 511, y * 1031, (x + y) * 331); }
+static void checkColor(linear48& p, int x, int y) { p = linear48(x * 511, y * 1031, (x + y) * 331); }
+
+template <typename P>
+static void checkDest(const char* typeName, const std::string& prefix, BitmapSprite& sprite, const std::string& filter, std::vector<Digest>& digests) {
+    // helper function renders the sprite once over the check background, at several sprite alphas
+    const uint8_t alphas[] = {77, 128, 255};
+    std::vector<P> buffer(kMatrixWidth * kMatrixHeight);
+    for (uint8_t alpha : alphas) {
+        char name[128];
+        snprintf(name, sizeof(name), "%s/%s/a%d", prefix.c_str(), typeName, alpha);
+        if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+        for (int y = 0; y < kMatrixHeight; y++) {
+            for (int x = 0; x < kMatrixWidth; x++) checkColor(buffer[y * kMatrixWidth + x], x, y);
+        }
+        sprite.alpha = alpha;
+        sprite.render(buffer.data());
+        digests.push_back({name, hashBytes(buffer.data(), buffer.size() * sizeof(P))});
+    }
+}
+
+static void checkSprites(const std::string& filter, std::vector<Digest>& digests) {
+    // every format, load mode and drawing buffer type, placed as loaded and with a rotated bilinear transform;
+    // the odd size leaves a remainder after every batch width. Each sprite is also drawn tinted, through a
+    // non-diagonal color matrix, for indexed images in their own format with a swapped palette, and with
+    // every blend mode other than source-over.
+    struct Look {
+        const char* name;
+        bool mapped;
+        BitmapSprite::ColorTransform transform;
+        bool swapped;
+        BitmapSprite::BlendMode blend;
+    };
+    const Look looks[] = {
+        {"", false, BitmapSprite::ColorTransform(), false, BitmapSprite::BLEND_OVER},
+        {"/tint", true, BitmapSprite::ColorTransform::tint(255, 160, 64), false, BitmapSprite::BLEND_OVER},
+        {"/saturation", true, BitmapSprite::ColorTransform::saturation(96), false, BitmapSprite::BLEND_OVER},
+        {"/palette", false, BitmapSprite::ColorTransform(), true, BitmapSprite::BLEND_OVER},
+        {"/add", false, BitmapSprite::ColorTransform(), false, BitmapSprite::BLEND_ADD},
+        {"/multiply", false, BitmapSprite::ColorTransform(), false, BitmapSprite::BLEND_MULTIPLY},
+        {"/screen", false, BitmapSprite::ColorTransform(), false, BitmapSprite::BLEND_SCREEN},
+        {"/replace", false, BitmapSprite::ColorTransform(), false, BitmapSprite::BLEND_REPLACE},
+    };
+    const int sizes[] = {13, 32};
+    const char* modeNames[] = {"bmp", "rgb24a", "linear"};
+    const char* variants[] = {"plain", "bilinear"};
+    std::vector<rgb24> colors(256);
+    for (int i = 0; i < 256; i++) colors[i] = rgb24(255 - i, i * 5, i * 3);
+
+    for (const BmpFormat& f : formats) {
+        for (int size : sizes) {
+            writeBitmap("bench.bmp", makeBitmap(f, size, size));
+
+            for (int mode = 0; mode < 3; mode++) {
+                BitmapSprite sprite("bench.bmp", (BitmapSprite::LoadMode)mode);
+                for (const Look& look : looks) {
+                    if (look.swapped && (f.bitspp > 8 || mode != 0)) continue; // the converting modes drop the palette
+                    if (look.mapped) {
+                        sprite.setColorTransform(look.transform);
+                    } else {
+                        sprite.resetColorTransform();
+                    }
+                    if (look.swapped) {
+                        sprite.setPalette(colors.data(), 1 << f.bitspp);
+                    } else {
+                        sprite.resetPalette();
+                    }
+                    sprite.blend = look.blend;
+
+                    for (int variant = 0; variant < 2; variant++) {
+                        sprite.x = -3; // clipped on the left
+                        sprite.y = 10 + size - 1;
+                        sprite.transformed = variant == 1;
+                        sprite.transform.x = (24 << 16) + 0x5000;
+                        sprite.transform.y = (20 << 16) + 0x3000;
+                        sprite.transform.angle = 4000;
+                        sprite.transform.bilinear = true;
+
+                        char prefix[96];
+                        snprintf(prefix, sizeof(prefix), "check/%s/%dx%d/%s/%s%s", f.name, size, size, modeNames[mode], variants[variant], look.name);
+                        checkDest<rgb16>("rgb16", prefix, sprite, filter, digests);
+                        checkDest<rgb24>("rgb24", prefix, sprite, filter, digests);
+                        checkDest<rgb48>("rgb48", prefix, sprite, filter, digests);
+                        checkDest<linear48>("linear48", prefix, sprite, filter, digests);
+                    }
+                }
+            }
+        }
+    }
+}
+
+static int checkBatches(const std::string& filter, std::vector<Digest>& digests) {
+    // a batch of translucent sprites over opaque panels, rendered serially and with occlusion and on worker threads;
+    // returns the number of variants that differ from the serial batch
+    const int count = 2000;
+    const uint16_t width = 512;
+    const uint16_t height = 256;
+    int failures = 0;
+
+    writeBitmap("bench.bmp", makeBitmap(formats[8], 16, 16)); // argb32
+    BitmapSprite round("bench.bmp");
+    writeBitmap("bench.bmp", makeBitmap(formats[4], 48, 32)); // rgb565
+    BitmapSprite panel("bench.bmp");
+
+    BitmapSprite::setDisplaySize(width, height);
+    std::mt19937 rng(1);
+    std::vector<BitmapSprite> sprites(count / 4, panel);
+    sprites.resize(count, round);
+    for (BitmapSprite& sprite : sprites) {
+        sprite.x = (int)(rng() % (width + 16)) - 16;
+        sprite.y = (int)(rng() % (height + 16));
+        sprite.alpha = (rng() % 3) ? 255 : rng() % 256;
+    }
+
+    const char* variants[] = {"serial", "occlusion", "threads4"};
+    for (int dest = 0; dest < 2; dest++) {
+        uint64_t serial = 0;
+        for (int variant = 0; variant < 3; variant++) {
+#if !defined(BITMAPSPRITE_THREADS)
+            if (variant == 2) continue;
+#endif
+            char name[96];
+            snprintf(name, sizeof(name), "check/batch/%dx%d/%d/%s/%s", width, height, count, dest ? "linear48" : "rgb24", variants[variant]);
+            if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+            SpriteBatch batch;
+            batch.setOcclusion(variant == 1);
+#if defined(BITMAPSPRITE_THREADS)
+            if (variant == 2) batch.setThreads(4);
+#endif
+            for (BitmapSprite& sprite : sprites) batch.add(sprite);
+            uint64_t hash;
+            if (dest) {
+                LinearBuffer accum;
+                accum.clear();
+                batch.render(accum.buffer());
+                hash = hashBytes(accum.buffer(), (size_t)width * height * sizeof(linear48));
+            } else {
+                std::vector<rgb24> buffer(width * height);
+                for (int y = 0; y < height; y++) {
+                    for (int x = 0; x < width; x++) checkColor(buffer[y * width + x], x, y);
+                }
+                batch.render(buffer.data());
+                hash = hashBytes(buffer.data(), buffer.size() * sizeof(rgb24));
+            }
+            digests.push_back({name, hash});
+
+            if (variant == 0) {
+                serial = hash;
+            } else if (serial && hash != serial) {
+                printf("differs from serial: %s\n", name);
+                failures++;
+            }
+        }
+    }
+    BitmapSprite::setDisplaySize(kMatrixWidth, kMatrixHeight);
+    return failures;
+}
+
+static int checkOutput(const std::string& digestFile, bool verify, const std::string& filter) {
+    // renders the check cases once and writes their buffer hashes to digestFile, or compares them with it;
+    // returns the process exit status
+    std::vector<Digest> digests;
+    checkSprites(filter, digests);
+    int failures = checkBatches(filter, digests);
+    SD.remove("bench.bmp");
+
+    if (!verify) {
+        FILE* out = fopen(digestFile.c_str(), "w");
+        if (!out) {
+            printf("Error: cannot write %s\n", digestFile.c_str());
+            return 1;
+        }
+        for (const Digest& d : digests) fprintf(out, "%s %016llx\n", d.name.c_str(), (unsigned long long)d.hash);
+        fclose(out);
+        printf("%d cases written to %s\n", (int)digests.size(), digestFile.c_str());
+        return failures ? 1 : 0;
+    }
+
+    FILE* in = fopen(digestFile.c_str(), "r");
+    if (!in) {
+        printf("Error: cannot read %s\n", digestFile.c_str());
+        return 1;
+    }
+    std::vector<Digest> expected;
+    char name[128];
+    unsigned long long hash;
+    while (fscanf(in, "%127s %llx", name, &hash) == 2) expected.push_back({name, hash});
+    fclose(in);
+
+    int compared = 0;
+    for (const Digest& d : digests) {
+        auto it = std::find_if(expected.begin(), expected.end(), [&](const Digest& e) { return e.name == d.name; });
+        if (it == expected.end()) continue;
+        compared++;
+        if (it->hash != d.hash) {
+            printf("differs from %s: %s\n", digestFile.c_str(), d.name.c_str());
+            failures++;
+        }
+    }
+    printf("%d cases compared with %s, %d differ\n", compared, digestFile.c_str(), failures);
+    return (failures || !compared) ? 1 : 0;
+}
+
+int main(int argc, char** argv) {
+    bool quick = false;
+    bool csv = false;
+    std::string digestFile;
+    std::string verifyFile;
+    std::string filter;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--quick") quick = true;
+        else if (arg == "--csv") csv = true;
+        else if (arg == "--digest" && i + 1 < argc) digestFile = argv[++i];
+        else if (arg == "--verify" && i + 1 < argc) verifyFile = argv[++i];
+        else filter = arg;
+    }
+    double minSeconds = quick ? 0.002 : 0.05;
+
+    SD.setRoot(".");
+    BitmapSprite::setDisplaySize(kMatrixWidth, kMatrixHeight);
+    if (verifyFile.size()) return checkOutput(verifyFile, true, filter);
+    if (digestFile.size()) return checkOutput(digestFile, false, filter);
+    std::vector<rgb24> buffer(kMatrixWidth * kMatrixHeight, rgb24(40, 80, 120));
+
+    const int sizes[] = {8, 16, 32, 64};
+    const uint8_t alphas[] = {0, 128, 255};
+    const char* modeNames[] = {"bmp", "rgb24a", "linear"};
+    const char* clipNames[] = {"full", "clipped"};
+
+    std::vector<Result> results;
+
+    for (const BmpFormat& f : formats) {
+        for (int size : sizes) {
+            writeBitmap("bench.bmp", makeBitmap(f, size, size));
+
+            for (int mode = 0; mode < 3; mode++) {
+                BitmapSprite sprite("bench.bmp", (BitmapSprite::LoadMode)mode);
+                for (int clip = 0; clip < 2; clip++) {
+                    for (uint8_t alpha : alphas) {
+                        char name[96];
+                        snprintf(name, sizeof(name), "%s/%dx%d/%s/%s/a%d", f.name, size, size, modeNames[mode], clipNames[clip], alpha);
+                        if (filter.size() && std::string(name).find(filter) == std::string::npos) continue;
+
+                        // bottom-up bitmaps are placed by their bottom left corner;
+                        // the clipped case hangs half the sprite off the top left of the display
+                        sprite.x = clip ? -size / 2 : 10;
+                        sprite.y = clip ? size / 2 - 1 : 10 + size - 1;
+                        sprite.alpha = alpha;
+                        int visible = clip ? (size - size / 2) * (size - size / 2) : size * size;
+
+                        Result r;
+                        r.name = name;
+                        r.nsPerCall = timeRenders(sprite, buffer, minSeconds);
+                        r.nsPerPixel = r.nsPerCall / visible;
+                        r.spritesPerFrame = 1e9 / 60 / r.nsPerCall;
+                        results.push_back(r);
+                    }
+                }
+            }
+        }
+    }
+    benchScenes(minSeconds, filter, results);
+    benchStack(minSeconds, filter, results);
+    benchScroll(minSeconds, filter, results);
+    benchLoad(minSeconds, filter, results);
+    benchDest(minSeconds, filter, results);
+    benchAffine(minSeconds, filter, results);
+    benchPalette(minSeconds, filter, results);
+    benchColor(minSeconds, filter, results);
+    benchBlend(minSeconds, filter, results);
+    benchCollide(minSeconds, filter, results);
+    benchText(minSeconds, filter, results);
+    SD.remove("bench.bmp");
+
+    if (csv) {
+        printf("case,ns_per_call,ns_per_pixel,sprites_per_frame\n");
+        for (const Result& r : results) printf("%s,%.1f,%.3f,%.0f\n", r.name.c_str(), r.nsPerCall, r.nsPerPixel, r.spritesPerFrame);
+    } else {
+        printf("%-40s %12s %12s %16s\n", "case", "ns/call", "ns/pixel", "sprites/frame");
+        for (const Result& r : results) printf("%-40s %12.1f %12.3f %16.0f\n", r.name.c_str(), r.nsPerCall, r.nsPerPixel, r.spritesPerFrame);
+        printf("(sprites/frame: renders that fit in one 60 Hz frame on this machine)\n");
+#if defined(BITMAPSPRITE_STATS)
+        printf("\nrender stats, all cases:\n");
+        BitmapSprite::printStats();
+#endif
+    }
+    return 0;
+}
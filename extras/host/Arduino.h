@@ -0,0 +1,60 @@
+/*
+    Host stand-in for the Arduino core, used to build BitmapSprite on a desktop machine.
+
+    Only the parts used by the library are provided.
+*/
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <math.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#ifdef __cplusplus
+
+#include <cstdio>
+#include <type_traits>
+
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type min(A a, B b) { return a < b ? a : b; }
+
+template <typename A, typename B>
+inline typename std::common_type<A, B>::type max(A a, B b) { return a < b ? b : a; }
+
+uint32_t millis();
+uint32_t micros();
+void delay(uint32_t ms);
+long random(long howbig);
+long random(long howsmall, long howbig);
+
+// the data cache only matters for DMA on the Teensy
+inline void arm_dcache_flush_delete(void* addr, uint32_t size) { (void)addr; (void)size; }
+
+class HostSerial { // prints to stdout
+    public:
+        void begin(uint32_t baud) { (void)baud; }
+        void print(const char* s) { fputs(s, stdout); }
+        void print(char c) { fputc(c, stdout); }
+        void print(int n) { printf("%d", n); }
+        void print(unsigned int n) { printf("%u", n); }
+        void print(long n) { printf("%ld", n); }
+        void print(unsigned long n) { printf("%lu", n); }
+        void print(double n) { printf("%.2f", n); }
+        template <typename T>
+        void println(T value) { print(value); fputc('\n', stdout); }
+        void println() { fputc('\n', stdout); }
+        template <typename... Args>
+        int printf(const char* format, Args... args) { return ::printf(format, args...); }
+        int printf(const char* s) { return fputs(s, stdout); }
+        explicit operator bool() { return true; }
+};
+
+extern HostSerial Serial;
+
+#endif // __cplusplus
+
+#endif
@@ -0,0 +1,63 @@
+/*
+    Host stand-in for the SmartMatrix color types.
+*/
+
+#ifndef MatrixCommon_h
+#define MatrixCommon_h
+
+#include <stdint.h>
+
+struct rgb48;
+
+typedef struct rgb16 {
+    rgb16() : rgb16(0, 0, 0) {}
+    rgb16(uint16_t r, uint16_t g, uint16_t b) {
+        red = r; green = g; blue = b;
+    }
+
+    uint16_t red : 5;
+    uint16_t green : 6;
+    uint16_t blue : 5;
+} rgb16;
+
+typedef struct rgb24 {
+    rgb24() : rgb24(0, 0, 0) {}
+    rgb24(uint8_t r, uint8_t g, uint8_t b) {
+        red = r; green = g; blue = b;
+    }
+    rgb24(const rgb48& col);
+    rgb24& operator=(const rgb48& col);
+
+    uint8_t red;
+    uint8_t green;
+    uint8_t blue;
+} rgb24;
+
+typedef struct rgb48 {
+    rgb48() : rgb48(0, 0, 0) {}
+    rgb48(uint16_t r, uint16_t g, uint16_t b) {
+        red = r; green = g; blue = b;
+    }
+    rgb48(const rgb24& col) {
+        red = (col.red << 8) | col.red; green = (col.green << 8) | col.green; blue = (col.blue << 8) | col.blue;
+    }
+    rgb48& operator=(const rgb24& col) {
+        red = (col.red << 8) | col.red; green = (col.green << 8) | col.green; blue = (col.blue << 8) | col.blue;
+        return *this;
+    }
+
+    uint16_t red;
+    uint16_t green;
+    uint16_t blue;
+} rgb48;
+
+inline rgb24::rgb24(const rgb48& col) {
+    red = col.red >> 8; green = col.green >> 8; blue = col.blue >> 8;
+}
+
+inline rgb24& rgb24::operator=(const rgb48& col) {
+    red = col.red >> 8; green = col.green >> 8; blue = col.blue >> 8;
+    return *this;
+}
+
+#endif
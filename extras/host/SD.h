@@ -0,0 +1,54 @@
+/*
+    Host stand-in for the Teensy SD library. Files are read from a directory on the host,
+    the current directory by default.
+*/
+
+#ifndef SD_h
+#define SD_h
+
+#include <Arduino.h>
+#include <string>
+
+#define FILE_READ 0
+#define FILE_WRITE 1
+#define BUILTIN_SDCARD 254
+
+class File {
+    public:
+        File() {}
+        File(FILE* f) : fp(f) {}
+
+        size_t size();
+        size_t position() { return fp ? ftell(fp) : 0; }
+        bool seek(size_t pos) { return fp && fseek(fp, pos, SEEK_SET) == 0; }
+        int available() { return size() - position(); }
+        int read(void* buf, size_t nbyte) { return fp ? fread(buf, 1, nbyte, fp) : -1; }
+        size_t write(const void* buf, size_t size) { return fp ? fwrite(buf, 1, size, fp) : 0; }
+        void close();
+        operator bool() const { return fp != nullptr; }
+
+    private:
+        FILE* fp = nullptr;
+};
+
+class SDClass {
+    public:
+        bool begin(uint8_t csPin = BUILTIN_SDCARD) { (void)csPin; return true; }
+        File open(const char* filename, uint8_t mode = FILE_READ);
+        bool exists(const char* filename);
+        bool remove(const char* filename);
+
+        // host only: directory that stands in for the root of the SD card
+        void setRoot(const char* dir) { root = dir; }
+        std::string path(const char* filename);
+        // host only: maps a file into memory read-only, e.g. for BitmapSprite::loadBaked(); nullptr on failure
+        const uint8_t* map(const char* filename, size_t& size);
+        void unmap(const uint8_t* data, size_t size);
+
+    private:
+        std::string root = ".";
+};
+
+extern SDClass SD;
+
+#endif
@@ -0,0 +1,94 @@
+/*
+    Host stand-ins for the Arduino core and SD library.
+*/
+
+#include <Arduino.h>
+#include <SD.h>
+
+#include <chrono>
+#include <random>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+HostSerial Serial;
+SDClass SD;
+
+static const std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+
+uint32_t millis() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+uint32_t micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - startTime).count();
+}
+
+void delay(uint32_t ms) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(ms));
+}
+
+static std::mt19937 rng;
+
+long random(long howbig) {
+    if (howbig <= 0) return 0;
+    return rng() % howbig;
+}
+
+long random(long howsmall, long howbig) {
+    if (howsmall >= howbig) return howsmall;
+    return howsmall + random(howbig - howsmall);
+}
+
+size_t File::size() {
+    if (!fp) return 0;
+    long pos = ftell(fp);
+    fseek(fp, 0, SEEK_END);
+    long end = ftell(fp);
+    fseek(fp, pos, SEEK_SET);
+    return end;
+}
+
+void File::close() {
+    if (fp) fclose(fp);
+    fp = nullptr;
+}
+
+std::string SDClass::path(const char* filename) {
+    while (*filename == '/') filename++;
+    return root + "/" + filename;
+}
+
+File SDClass::open(const char* filename, uint8_t mode) {
+    return File(fopen(path(filename).c_str(), mode == FILE_WRITE ? "wb" : "rb"));
+}
+
+bool SDClass::exists(const char* filename) {
+    FILE* fp = fopen(path(filename).c_str(), "rb");
+    if (fp) fclose(fp);
+    return fp != nullptr;
+}
+
+bool SDClass::remove(const char* filename) {
+    return ::remove(path(filename).c_str()) == 0;
+}
+
+const uint8_t* SDClass::map(const char* filename, size_t& size) {
+    size = 0;
+    int fd = ::open(path(filename).c_str(), O_RDONLY);
+    if (fd < 0) return nullptr;
+    struct stat st;
+    void* data = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0) data = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd); // the mapping stays valid
+    if (data == MAP_FAILED) return nullptr;
+    size = st.st_size;
+    return (const uint8_t*)data;
+}
+
+void SDClass::unmap(const uint8_t* data, size_t size) {
+    if (data) munmap((void*)data, size);
+}
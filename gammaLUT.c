@@ -152,3 +152,264 @@ const uint8_t invGammaLUT12to8[]={
   0xFD,0xFD,0xFD,0xFD,0xFD,0xFD,0xFD,0xFD,0xFD,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,
   0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFE,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF,0xFF
   };
+
+/* 12bit to 16bit SRGB gamma encoding table, interpolated to 16bit input (one extra entry for the last step) */
+const uint16_t invGammaLUT12to16[]={
+  0x0000,0x00CF,0x019D,0x026C,0x033B,0x040A,0x04D8,0x05A7,0x0676,0x0744,0x0813,0x08E2,0x09B1,0x0A7F,0x0B44,0x0C01,
+  0x0CB7,0x0D67,0x0E10,0x0EB4,0x0F53,0x0FEE,0x1084,0x1117,0x11A6,0x1231,0x12B9,0x133E,0x13C0,0x1440,0x14BD,0x1538,
+  0x15B0,0x1626,0x169A,0x170C,0x177D,0x17EB,0x1858,0x18C3,0x192C,0x1994,0x19FA,0x1A60,0x1AC3,0x1B26,0x1B87,0x1BE7,
+  0x1C45,0x1CA3,0x1CFF,0x1D5B,0x1DB5,0x1E0E,0x1E67,0x1EBE,0x1F14,0x1F6A,0x1FBF,0x2013,0x2066,0x20B8,0x2109,0x215A,
+  0x21AA,0x21F9,0x2248,0x2295,0x22E3,0x232F,0x237B,0x23C6,0x2411,0x245B,0x24A4,0x24ED,0x2535,0x257D,0x25C4,0x260B,
+  0x2651,0x2696,0x26DB,0x2720,0x2764,0x27A8,0x27EB,0x282E,0x2870,0x28B2,0x28F3,0x2934,0x2975,0x29B5,0x29F5,0x2A34,
+  0x2A73,0x2AB2,0x2AF0,0x2B2E,0x2B6C,0x2BA9,0x2BE6,0x2C22,0x2C5E,0x2C9A,0x2CD5,0x2D11,0x2D4B,0x2D86,0x2DC0,0x2DFA,
+  0x2E33,0x2E6D,0x2EA6,0x2EDE,0x2F17,0x2F4F,0x2F87,0x2FBE,0x2FF6,0x302D,0x3063,0x309A,0x30D0,0x3106,0x313C,0x3171,
+  0x31A6,0x31DB,0x3210,0x3245,0x3279,0x32AD,0x32E1,0x3314,0x3348,0x337B,0x33AE,0x33E1,0x3413,0x3445,0x3477,0x34A9,
+  0x34DB,0x350D,0x353E,0x356F,0x35A0,0x35D0,0x3601,0x3631,0x3661,0x3691,0x36C1,0x36F1,0x3720,0x374F,0x377E,0x37AD,
+  0x37DC,0x380B,0x3839,0x3867,0x3895,0x38C3,0x38F1,0x391E,0x394C,0x3979,0x39A6,0x39D3,0x3A00,0x3A2C,0x3A59,0x3A85,
+  0x3AB1,0x3ADD,0x3B09,0x3B35,0x3B61,0x3B8C,0x3BB7,0x3BE3,0x3C0E,0x3C39,0x3C63,0x3C8E,0x3CB8,0x3CE3,0x3D0D,0x3D37,
+  0x3D61,0x3D8B,0x3DB5,0x3DDE,0x3E08,0x3E31,0x3E5A,0x3E84,0x3EAD,0x3ED5,0x3EFE,0x3F27,0x3F4F,0x3F78,0x3FA0,0x3FC8,
+  0x3FF0,0x4018,0x4040,0x4068,0x408F,0x40B7,0x40DE,0x4106,0x412D,0x4154,0x417B,0x41A2,0x41C9,0x41EF,0x4216,0x423C,
+  0x4263,0x4289,0x42AF,0x42D5,0x42FB,0x4321,0x4347,0x436D,0x4392,0x43B8,0x43DD,0x4402,0x4428,0x444D,0x4472,0x4497,
+  0x44BB,0x44E0,0x4505,0x4529,0x454E,0x4572,0x4597,0x45BB,0x45DF,0x4603,0x4627,0x464B,0x466F,0x4693,0x46B6,0x46DA,
+  0x46FD,0x4721,0x4744,0x4767,0x478A,0x47AD,0x47D1,0x47F3,0x4816,0x4839,0x485C,0x487E,0x48A1,0x48C3,0x48E6,0x4908,
+  0x492A,0x494D,0x496F,0x4991,0x49B3,0x49D5,0x49F6,0x4A18,0x4A3A,0x4A5B,0x4A7D,0x4A9E,0x4AC0,0x4AE1,0x4B02,0x4B24,
+  0x4B45,0x4B66,0x4B87,0x4BA8,0x4BC9,0x4BE9,0x4C0A,0x4C2B,0x4C4B,0x4C6C,0x4C8C,0x4CAD,0x4CCD,0x4CED,0x4D0E,0x4D2E,
+  0x4D4E,0x4D6E,0x4D8E,0x4DAE,0x4DCE,0x4DED,0x4E0D,0x4E2D,0x4E4C,0x4E6C,0x4E8B,0x4EAB,0x4ECA,0x4EEA,0x4F09,0x4F28,
+  0x4F47,0x4F66,0x4F85,0x4FA4,0x4FC3,0x4FE2,0x5001,0x5020,0x503E,0x505D,0x507C,0x509A,0x50B9,0x50D7,0x50F5,0x5114,
+  0x5132,0x5150,0x516E,0x518D,0x51AB,0x51C9,0x51E7,0x5204,0x5222,0x5240,0x525E,0x527C,0x5299,0x52B7,0x52D4,0x52F2,
+  0x530F,0x532D,0x534A,0x5368,0x5385,0x53A2,0x53BF,0x53DC,0x53F9,0x5416,0x5433,0x5450,0x546D,0x548A,0x54A7,0x54C4,
+  0x54E0,0x54FD,0x551A,0x5536,0x5553,0x556F,0x558C,0x55A8,0x55C4,0x55E1,0x55FD,0x5619,0x5635,0x5651,0x566D,0x568A,
+  0x56A6,0x56C1,0x56DD,0x56F9,0x5715,0x5731,0x574D,0x5768,0x5784,0x57A0,0x57BB,0x57D7,0x57F2,0x580E,0x5829,0x5845,
+  0x5860,0x587B,0x5896,0x58B2,0x58CD,0x58E8,0x5903,0x591E,0x5939,0x5954,0x596F,0x598A,0x59A5,0x59C0,0x59DB,0x59F5,
+  0x5A10,0x5A2B,0x5A45,0x5A60,0x5A7B,0x5A95,0x5AB0,0x5ACA,0x5AE4,0x5AFF,0x5B19,0x5B34,0x5B4E,0x5B68,0x5B82,0x5B9C,
+  0x5BB7,0x5BD1,0x5BEB,0x5C05,0x5C1F,0x5C39,0x5C53,0x5C6D,0x5C86,0x5CA0,0x5CBA,0x5CD4,0x5CEE,0x5D07,0x5D21,0x5D3B,
+  0x5D54,0x5D6E,0x5D87,0x5DA1,0x5DBA,0x5DD4,0x5DED,0x5E06,0x5E20,0x5E39,0x5E52,0x5E6B,0x5E85,0x5E9E,0x5EB7,0x5ED0,
+  0x5EE9,0x5F02,0x5F1B,0x5F34,0x5F4D,0x5F66,0x5F7F,0x5F98,0x5FB1,0x5FC9,0x5FE2,0x5FFB,0x6014,0x602C,0x6045,0x605D,
+  0x6076,0x608F,0x60A7,0x60C0,0x60D8,0x60F0,0x6109,0x6121,0x613A,0x6152,0x616A,0x6182,0x619B,0x61B3,0x61CB,0x61E3,
+  0x61FB,0x6213,0x622B,0x6243,0x625B,0x6273,0x628B,0x62A3,0x62BB,0x62D3,0x62EB,0x6303,0x631A,0x6332,0x634A,0x6362,
+  0x6379,0x6391,0x63A9,0x63C0,0x63D8,0x63EF,0x6407,0x641E,0x6436,0x644D,0x6465,0x647C,0x6493,0x64AB,0x64C2,0x64D9,
+  0x64F0,0x6508,0x651F,0x6536,0x654D,0x6564,0x657B,0x6592,0x65A9,0x65C1,0x65D8,0x65EE,0x6605,0x661C,0x6633,0x664A,
+  0x6661,0x6678,0x668F,0x66A5,0x66BC,0x66D3,0x66EA,0x6700,0x6717,0x672E,0x6744,0x675B,0x6771,0x6788,0x679E,0x67B5,
+  0x67CB,0x67E2,0x67F8,0x680E,0x6825,0x683B,0x6852,0x6868,0x687E,0x6894,0x68AB,0x68C1,0x68D7,0x68ED,0x6903,0x6919,
+  0x6930,0x6946,0x695C,0x6972,0x6988,0x699E,0x69B4,0x69CA,0x69E0,0x69F5,0x6A0B,0x6A21,0x6A37,0x6A4D,0x6A63,0x6A78,
+  0x6A8E,0x6AA4,0x6ABA,0x6ACF,0x6AE5,0x6AFA,0x6B10,0x6B26,0x6B3B,0x6B51,0x6B66,0x6B7C,0x6B91,0x6BA7,0x6BBC,0x6BD2,
+  0x6BE7,0x6BFD,0x6C12,0x6C27,0x6C3D,0x6C52,0x6C67,0x6C7C,0x6C92,0x6CA7,0x6CBC,0x6CD1,0x6CE7,0x6CFC,0x6D11,0x6D26,
+  0x6D3B,0x6D50,0x6D65,0x6D7A,0x6D8F,0x6DA4,0x6DB9,0x6DCE,0x6DE3,0x6DF8,0x6E0D,0x6E22,0x6E37,0x6E4B,0x6E60,0x6E75,
+  0x6E8A,0x6E9F,0x6EB3,0x6EC8,0x6EDD,0x6EF1,0x6F06,0x6F1B,0x6F2F,0x6F44,0x6F59,0x6F6D,0x6F82,0x6F96,0x6FAB,0x6FBF,
+  0x6FD4,0x6FE8,0x6FFD,0x7011,0x7025,0x703A,0x704E,0x7063,0x7077,0x708B,0x709F,0x70B4,0x70C8,0x70DC,0x70F1,0x7105,
+  0x7119,0x712D,0x7141,0x7155,0x716A,0x717E,0x7192,0x71A6,0x71BA,0x71CE,0x71E2,0x71F6,0x720A,0x721E,0x7232,0x7246,
+  0x725A,0x726E,0x7281,0x7295,0x72A9,0x72BD,0x72D1,0x72E5,0x72F8,0x730C,0x7320,0x7334,0x7347,0x735B,0x736F,0x7382,
+  0x7396,0x73AA,0x73BD,0x73D1,0x73E5,0x73F8,0x740C,0x741F,0x7433,0x7446,0x745A,0x746D,0x7481,0x7494,0x74A8,0x74BB,
+  0x74CE,0x74E2,0x74F5,0x7509,0x751C,0x752F,0x7542,0x7556,0x7569,0x757C,0x7590,0x75A3,0x75B6,0x75C9,0x75DC,0x75F0,
+  0x7603,0x7616,0x7629,0x763C,0x764F,0x7662,0x7675,0x7688,0x769B,0x76AE,0x76C1,0x76D4,0x76E7,0x76FA,0x770D,0x7720,
+  0x7733,0x7746,0x7759,0x776C,0x777F,0x7791,0x77A4,0x77B7,0x77CA,0x77DD,0x77EF,0x7802,0x7815,0x7828,0x783A,0x784D,
+  0x7860,0x7872,0x7885,0x7898,0x78AA,0x78BD,0x78CF,0x78E2,0x78F5,0x7907,0x791A,0x792C,0x793F,0x7951,0x7964,0x7976,
+  0x7989,0x799B,0x79AE,0x79C0,0x79D2,0x79E5,0x79F7,0x7A0A,0x7A1C,0x7A2E,0x7A41,0x7A53,0x7A65,0x7A77,0x7A8A,0x7A9C,
+  0x7AAE,0x7AC0,0x7AD3,0x7AE5,0x7AF7,0x7B09,0x7B1B,0x7B2D,0x7B40,0x7B52,0x7B64,0x7B76,0x7B88,0x7B9A,0x7BAC,0x7BBE,
+  0x7BD0,0x7BE2,0x7BF4,0x7C06,0x7C18,0x7C2A,0x7C3C,0x7C4E,0x7C60,0x7C72,0x7C84,0x7C96,0x7CA8,0x7CB9,0x7CCB,0x7CDD,
+  0x7CEF,0x7D01,0x7D13,0x7D24,0x7D36,0x7D48,0x7D5A,0x7D6B,0x7D7D,0x7D8F,0x7DA1,0x7DB2,0x7DC4,0x7DD6,0x7DE7,0x7DF9,
+  0x7E0B,0x7E1C,0x7E2E,0x7E3F,0x7E51,0x7E63,0x7E74,0x7E86,0x7E97,0x7EA9,0x7EBA,0x7ECC,0x7EDD,0x7EEF,0x7F00,0x7F12,
+  0x7F23,0x7F34,0x7F46,0x7F57,0x7F69,0x7F7A,0x7F8B,0x7F9D,0x7FAE,0x7FBF,0x7FD1,0x7FE2,0x7FF3,0x8005,0x8016,0x8027,
+  0x8038,0x804A,0x805B,0x806C,0x807D,0x808F,0x80A0,0x80B1,0x80C2,0x80D3,0x80E4,0x80F6,0x8107,0x8118,0x8129,0x813A,
+  0x814B,0x815C,0x816D,0x817E,0x818F,0x81A0,0x81B1,0x81C2,0x81D3,0x81E4,0x81F5,0x8206,0x8217,0x8228,0x8239,0x824A,
+  0x825B,0x826C,0x827C,0x828D,0x829E,0x82AF,0x82C0,0x82D1,0x82E2,0x82F2,0x8303,0x8314,0x8325,0x8335,0x8346,0x8357,
+  0x8368,0x8378,0x8389,0x839A,0x83AA,0x83BB,0x83CC,0x83DC,0x83ED,0x83FE,0x840E,0x841F,0x8430,0x8440,0x8451,0x8461,
+  0x8472,0x8482,0x8493,0x84A3,0x84B4,0x84C5,0x84D5,0x84E5,0x84F6,0x8506,0x8517,0x8527,0x8538,0x8548,0x8559,0x8569,
+  0x8579,0x858A,0x859A,0x85AB,0x85BB,0x85CB,0x85DC,0x85EC,0x85FC,0x860D,0x861D,0x862D,0x863D,0x864E,0x865E,0x866E,
+  0x867F,0x868F,0x869F,0x86AF,0x86BF,0x86D0,0x86E0,0x86F0,0x8700,0x8710,0x8720,0x8731,0x8741,0x8751,0x8761,0x8771,
+  0x8781,0x8791,0x87A1,0x87B1,0x87C1,0x87D1,0x87E1,0x87F1,0x8801,0x8811,0x8821,0x8831,0x8841,0x8851,0x8861,0x8871,
+  0x8881,0x8891,0x88A1,0x88B1,0x88C1,0x88D1,0x88E1,0x88F1,0x8900,0x8910,0x8920,0x8930,0x8940,0x8950,0x895F,0x896F,
+  0x897F,0x898F,0x899F,0x89AE,0x89BE,0x89CE,0x89DE,0x89ED,0x89FD,0x8A0D,0x8A1C,0x8A2C,0x8A3C,0x8A4C,0x8A5B,0x8A6B,
+  0x8A7A,0x8A8A,0x8A9A,0x8AA9,0x8AB9,0x8AC9,0x8AD8,0x8AE8,0x8AF7,0x8B07,0x8B17,0x8B26,0x8B36,0x8B45,0x8B55,0x8B64,
+  0x8B74,0x8B83,0x8B93,0x8BA2,0x8BB2,0x8BC1,0x8BD1,0x8BE0,0x8BF0,0x8BFF,0x8C0E,0x8C1E,0x8C2D,0x8C3D,0x8C4C,0x8C5B,
+  0x8C6B,0x8C7A,0x8C8A,0x8C99,0x8CA8,0x8CB8,0x8CC7,0x8CD6,0x8CE5,0x8CF5,0x8D04,0x8D13,0x8D23,0x8D32,0x8D41,0x8D50,
+  0x8D60,0x8D6F,0x8D7E,0x8D8D,0x8D9D,0x8DAC,0x8DBB,0x8DCA,0x8DD9,0x8DE9,0x8DF8,0x8E07,0x8E16,0x8E25,0x8E34,0x8E43,
+  0x8E52,0x8E62,0x8E71,0x8E80,0x8E8F,0x8E9E,0x8EAD,0x8EBC,0x8ECB,0x8EDA,0x8EE9,0x8EF8,0x8F07,0x8F16,0x8F25,0x8F34,
+  0x8F43,0x8F52,0x8F61,0x8F70,0x8F7F,0x8F8E,0x8F9D,0x8FAC,0x8FBB,0x8FCA,0x8FD9,0x8FE8,0x8FF7,0x9005,0x9014,0x9023,
+  0x9032,0x9041,0x9050,0x905F,0x906D,0x907C,0x908B,0x909A,0x90A9,0x90B7,0x90C6,0x90D5,0x90E4,0x90F3,0x9101,0x9110,
+  0x911F,0x912E,0x913C,0x914B,0x915A,0x9168,0x9177,0x9186,0x9195,0x91A3,0x91B2,0x91C1,0x91CF,0x91DE,0x91EC,0x91FB,
+  0x920A,0x9218,0x9227,0x9236,0x9244,0x9253,0x9261,0x9270,0x927E,0x928D,0x929C,0x92AA,0x92B9,0x92C7,0x92D6,0x92E4,
+  0x92F3,0x9301,0x9310,0x931E,0x932D,0x933B,0x934A,0x9358,0x9367,0x9375,0x9383,0x9392,0x93A0,0x93AF,0x93BD,0x93CC,
+  0x93DA,0x93E8,0x93F7,0x9405,0x9414,0x9422,0x9430,0x943F,0x944D,0x945B,0x946A,0x9478,0x9486,0x9495,0x94A3,0x94B1,
+  0x94BF,0x94CE,0x94DC,0x94EA,0x94F8,0x9507,0x9515,0x9523,0x9531,0x9540,0x954E,0x955C,0x956A,0x9579,0x9587,0x9595,
+  0x95A3,0x95B1,0x95BF,0x95CE,0x95DC,0x95EA,0x95F8,0x9606,0x9614,0x9622,0x9630,0x963F,0x964D,0x965B,0x9669,0x9677,
+  0x9685,0x9693,0x96A1,0x96AF,0x96BD,0x96CB,0x96D9,0x96E7,0x96F5,0x9703,0x9711,0x971F,0x972D,0x973B,0x9749,0x9757,
+  0x9765,0x9773,0x9781,0x978F,0x979D,0x97AB,0x97B9,0x97C7,0x97D5,0x97E3,0x97F1,0x97FE,0x980C,0x981A,0x9828,0x9836,
+  0x9844,0x9852,0x9860,0x986D,0x987B,0x9889,0x9897,0x98A5,0x98B3,0x98C0,0x98CE,0x98DC,0x98EA,0x98F8,0x9905,0x9913,
+  0x9921,0x992F,0x993C,0x994A,0x9958,0x9966,0x9973,0x9981,0x998F,0x999C,0x99AA,0x99B8,0x99C6,0x99D3,0x99E1,0x99EF,
+  0x99FC,0x9A0A,0x9A18,0x9A25,0x9A33,0x9A40,0x9A4E,0x9A5C,0x9A69,0x9A77,0x9A85,0x9A92,0x9AA0,0x9AAD,0x9ABB,0x9AC9,
+  0x9AD6,0x9AE4,0x9AF1,0x9AFF,0x9B0C,0x9B1A,0x9B27,0x9B35,0x9B42,0x9B50,0x9B5D,0x9B6B,0x9B78,0x9B86,0x9B93,0x9BA1,
+  0x9BAE,0x9BBC,0x9BC9,0x9BD7,0x9BE4,0x9BF2,0x9BFF,0x9C0D,0x9C1A,0x9C27,0x9C35,0x9C42,0x9C50,0x9C5D,0x9C6A,0x9C78,
+  0x9C85,0x9C93,0x9CA0,0x9CAD,0x9CBB,0x9CC8,0x9CD5,0x9CE3,0x9CF0,0x9CFD,0x9D0B,0x9D18,0x9D25,0x9D33,0x9D40,0x9D4D,
+  0x9D5B,0x9D68,0x9D75,0x9D82,0x9D90,0x9D9D,0x9DAA,0x9DB7,0x9DC5,0x9DD2,0x9DDF,0x9DEC,0x9DFA,0x9E07,0x9E14,0x9E21,
+  0x9E2F,0x9E3C,0x9E49,0x9E56,0x9E63,0x9E70,0x9E7E,0x9E8B,0x9E98,0x9EA5,0x9EB2,0x9EBF,0x9ECD,0x9EDA,0x9EE7,0x9EF4,
+  0x9F01,0x9F0E,0x9F1B,0x9F28,0x9F35,0x9F43,0x9F50,0x9F5D,0x9F6A,0x9F77,0x9F84,0x9F91,0x9F9E,0x9FAB,0x9FB8,0x9FC5,
+  0x9FD2,0x9FDF,0x9FEC,0x9FF9,0xA006,0xA013,0xA020,0xA02D,0xA03A,0xA047,0xA054,0xA061,0xA06E,0xA07B,0xA088,0xA095,
+  0xA0A2,0xA0AF,0xA0BC,0xA0C9,0xA0D6,0xA0E3,0xA0EF,0xA0FC,0xA109,0xA116,0xA123,0xA130,0xA13D,0xA14A,0xA157,0xA163,
+  0xA170,0xA17D,0xA18A,0xA197,0xA1A4,0xA1B0,0xA1BD,0xA1CA,0xA1D7,0xA1E4,0xA1F1,0xA1FD,0xA20A,0xA217,0xA224,0xA231,
+  0xA23D,0xA24A,0xA257,0xA264,0xA270,0xA27D,0xA28A,0xA297,0xA2A3,0xA2B0,0xA2BD,0xA2CA,0xA2D6,0xA2E3,0xA2F0,0xA2FC,
+  0xA309,0xA316,0xA323,0xA32F,0xA33C,0xA349,0xA355,0xA362,0xA36F,0xA37B,0xA388,0xA394,0xA3A1,0xA3AE,0xA3BA,0xA3C7,
+  0xA3D4,0xA3E0,0xA3ED,0xA3F9,0xA406,0xA413,0xA41F,0xA42C,0xA438,0xA445,0xA452,0xA45E,0xA46B,0xA477,0xA484,0xA490,
+  0xA49D,0xA4A9,0xA4B6,0xA4C2,0xA4CF,0xA4DC,0xA4E8,0xA4F5,0xA501,0xA50E,0xA51A,0xA527,0xA533,0xA540,0xA54C,0xA558,
+  0xA565,0xA571,0xA57E,0xA58A,0xA597,0xA5A3,0xA5B0,0xA5BC,0xA5C8,0xA5D5,0xA5E1,0xA5EE,0xA5FA,0xA607,0xA613,0xA61F,
+  0xA62C,0xA638,0xA645,0xA651,0xA65D,0xA66A,0xA676,0xA682,0xA68F,0xA69B,0xA6A7,0xA6B4,0xA6C0,0xA6CC,0xA6D9,0xA6E5,
+  0xA6F1,0xA6FE,0xA70A,0xA716,0xA723,0xA72F,0xA73B,0xA747,0xA754,0xA760,0xA76C,0xA779,0xA785,0xA791,0xA79D,0xA7AA,
+  0xA7B6,0xA7C2,0xA7CE,0xA7DB,0xA7E7,0xA7F3,0xA7FF,0xA80B,0xA818,0xA824,0xA830,0xA83C,0xA848,0xA855,0xA861,0xA86D,
+  0xA879,0xA885,0xA891,0xA89E,0xA8AA,0xA8B6,0xA8C2,0xA8CE,0xA8DA,0xA8E6,0xA8F3,0xA8FF,0xA90B,0xA917,0xA923,0xA92F,
+  0xA93B,0xA947,0xA953,0xA960,0xA96C,0xA978,0xA984,0xA990,0xA99C,0xA9A8,0xA9B4,0xA9C0,0xA9CC,0xA9D8,0xA9E4,0xA9F0,
+  0xA9FC,0xAA08,0xAA14,0xAA20,0xAA2C,0xAA38,0xAA44,0xAA50,0xAA5C,0xAA68,0xAA74,0xAA80,0xAA8C,0xAA98,0xAAA4,0xAAB0,
+  0xAABC,0xAAC8,0xAAD4,0xAAE0,0xAAEC,0xAAF8,0xAB04,0xAB10,0xAB1C,0xAB28,0xAB34,0xAB40,0xAB4B,0xAB57,0xAB63,0xAB6F,
+  0xAB7B,0xAB87,0xAB93,0xAB9F,0xABAB,0xABB7,0xABC2,0xABCE,0xABDA,0xABE6,0xABF2,0xABFE,0xAC0A,0xAC15,0xAC21,0xAC2D,
+  0xAC39,0xAC45,0xAC51,0xAC5C,0xAC68,0xAC74,0xAC80,0xAC8C,0xAC97,0xACA3,0xACAF,0xACBB,0xACC7,0xACD2,0xACDE,0xACEA,
+  0xACF6,0xAD01,0xAD0D,0xAD19,0xAD25,0xAD30,0xAD3C,0xAD48,0xAD54,0xAD5F,0xAD6B,0xAD77,0xAD82,0xAD8E,0xAD9A,0xADA6,
+  0xADB1,0xADBD,0xADC9,0xADD4,0xADE0,0xADEC,0xADF7,0xAE03,0xAE0F,0xAE1A,0xAE26,0xAE32,0xAE3D,0xAE49,0xAE55,0xAE60,
+  0xAE6C,0xAE78,0xAE83,0xAE8F,0xAE9B,0xAEA6,0xAEB2,0xAEBD,0xAEC9,0xAED5,0xAEE0,0xAEEC,0xAEF7,0xAF03,0xAF0F,0xAF1A,
+  0xAF26,0xAF31,0xAF3D,0xAF48,0xAF54,0xAF5F,0xAF6B,0xAF77,0xAF82,0xAF8E,0xAF99,0xAFA5,0xAFB0,0xAFBC,0xAFC7,0xAFD3,
+  0xAFDE,0xAFEA,0xAFF5,0xB001,0xB00C,0xB018,0xB023,0xB02F,0xB03A,0xB046,0xB051,0xB05D,0xB068,0xB074,0xB07F,0xB08B,
+  0xB096,0xB0A2,0xB0AD,0xB0B8,0xB0C4,0xB0CF,0xB0DB,0xB0E6,0xB0F2,0xB0FD,0xB108,0xB114,0xB11F,0xB12B,0xB136,0xB141,
+  0xB14D,0xB158,0xB164,0xB16F,0xB17A,0xB186,0xB191,0xB19C,0xB1A8,0xB1B3,0xB1BF,0xB1CA,0xB1D5,0xB1E1,0xB1EC,0xB1F7,
+  0xB203,0xB20E,0xB219,0xB225,0xB230,0xB23B,0xB247,0xB252,0xB25D,0xB268,0xB274,0xB27F,0xB28A,0xB296,0xB2A1,0xB2AC,
+  0xB2B7,0xB2C3,0xB2CE,0xB2D9,0xB2E5,0xB2F0,0xB2FB,0xB306,0xB312,0xB31D,0xB328,0xB333,0xB33E,0xB34A,0xB355,0xB360,
+  0xB36B,0xB377,0xB382,0xB38D,0xB398,0xB3A3,0xB3AF,0xB3BA,0xB3C5,0xB3D0,0xB3DB,0xB3E7,0xB3F2,0xB3FD,0xB408,0xB413,
+  0xB41E,0xB42A,0xB435,0xB440,0xB44B,0xB456,0xB461,0xB46C,0xB478,0xB483,0xB48E,0xB499,0xB4A4,0xB4AF,0xB4BA,0xB4C5,
+  0xB4D1,0xB4DC,0xB4E7,0xB4F2,0xB4FD,0xB508,0xB513,0xB51E,0xB529,0xB534,0xB53F,0xB54A,0xB556,0xB561,0xB56C,0xB577,
+  0xB582,0xB58D,0xB598,0xB5A3,0xB5AE,0xB5B9,0xB5C4,0xB5CF,0xB5DA,0xB5E5,0xB5F0,0xB5FB,0xB606,0xB611,0xB61C,0xB627,
+  0xB632,0xB63D,0xB648,0xB653,0xB65E,0xB669,0xB674,0xB67F,0xB68A,0xB695,0xB6A0,0xB6AB,0xB6B6,0xB6C1,0xB6CC,0xB6D7,
+  0xB6E2,0xB6ED,0xB6F8,0xB702,0xB70D,0xB718,0xB723,0xB72E,0xB739,0xB744,0xB74F,0xB75A,0xB765,0xB770,0xB77B,0xB785,
+  0xB790,0xB79B,0xB7A6,0xB7B1,0xB7BC,0xB7C7,0xB7D2,0xB7DC,0xB7E7,0xB7F2,0xB7FD,0xB808,0xB813,0xB81E,0xB828,0xB833,
+  0xB83E,0xB849,0xB854,0xB85F,0xB869,0xB874,0xB87F,0xB88A,0xB895,0xB8A0,0xB8AA,0xB8B5,0xB8C0,0xB8CB,0xB8D6,0xB8E0,
+  0xB8EB,0xB8F6,0xB901,0xB90B,0xB916,0xB921,0xB92C,0xB937,0xB941,0xB94C,0xB957,0xB962,0xB96C,0xB977,0xB982,0xB98D,
+  0xB997,0xB9A2,0xB9AD,0xB9B7,0xB9C2,0xB9CD,0xB9D8,0xB9E2,0xB9ED,0xB9F8,0xBA02,0xBA0D,0xBA18,0xBA23,0xBA2D,0xBA38,
+  0xBA43,0xBA4D,0xBA58,0xBA63,0xBA6D,0xBA78,0xBA83,0xBA8D,0xBA98,0xBAA3,0xBAAD,0xBAB8,0xBAC3,0xBACD,0xBAD8,0xBAE3,
+  0xBAED,0xBAF8,0xBB02,0xBB0D,0xBB18,0xBB22,0xBB2D,0xBB38,0xBB42,0xBB4D,0xBB57,0xBB62,0xBB6D,0xBB77,0xBB82,0xBB8C,
+  0xBB97,0xBBA2,0xBBAC,0xBBB7,0xBBC1,0xBBCC,0xBBD6,0xBBE1,0xBBEC,0xBBF6,0xBC01,0xBC0B,0xBC16,0xBC20,0xBC2B,0xBC35,
+  0xBC40,0xBC4A,0xBC55,0xBC60,0xBC6A,0xBC75,0xBC7F,0xBC8A,0xBC94,0xBC9F,0xBCA9,0xBCB4,0xBCBE,0xBCC9,0xBCD3,0xBCDE,
+  0xBCE8,0xBCF3,0xBCFD,0xBD08,0xBD12,0xBD1D,0xBD27,0xBD32,0xBD3C,0xBD46,0xBD51,0xBD5B,0xBD66,0xBD70,0xBD7B,0xBD85,
+  0xBD90,0xBD9A,0xBDA5,0xBDAF,0xBDB9,0xBDC4,0xBDCE,0xBDD9,0xBDE3,0xBDEE,0xBDF8,0xBE02,0xBE0D,0xBE17,0xBE22,0xBE2C,
+  0xBE36,0xBE41,0xBE4B,0xBE56,0xBE60,0xBE6A,0xBE75,0xBE7F,0xBE89,0xBE94,0xBE9E,0xBEA9,0xBEB3,0xBEBD,0xBEC8,0xBED2,
+  0xBEDC,0xBEE7,0xBEF1,0xBEFB,0xBF06,0xBF10,0xBF1A,0xBF25,0xBF2F,0xBF39,0xBF44,0xBF4E,0xBF58,0xBF63,0xBF6D,0xBF77,
+  0xBF82,0xBF8C,0xBF96,0xBFA0,0xBFAB,0xBFB5,0xBFBF,0xBFCA,0xBFD4,0xBFDE,0xBFE8,0xBFF3,0xBFFD,0xC007,0xC012,0xC01C,
+  0xC026,0xC030,0xC03B,0xC045,0xC04F,0xC059,0xC064,0xC06E,0xC078,0xC082,0xC08D,0xC097,0xC0A1,0xC0AB,0xC0B5,0xC0C0,
+  0xC0CA,0xC0D4,0xC0DE,0xC0E9,0xC0F3,0xC0FD,0xC107,0xC111,0xC11C,0xC126,0xC130,0xC13A,0xC144,0xC14E,0xC159,0xC163,
+  0xC16D,0xC177,0xC181,0xC18C,0xC196,0xC1A0,0xC1AA,0xC1B4,0xC1BE,0xC1C8,0xC1D3,0xC1DD,0xC1E7,0xC1F1,0xC1FB,0xC205,
+  0xC20F,0xC21A,0xC224,0xC22E,0xC238,0xC242,0xC24C,0xC256,0xC260,0xC26A,0xC275,0xC27F,0xC289,0xC293,0xC29D,0xC2A7,
+  0xC2B1,0xC2BB,0xC2C5,0xC2CF,0xC2D9,0xC2E4,0xC2EE,0xC2F8,0xC302,0xC30C,0xC316,0xC320,0xC32A,0xC334,0xC33E,0xC348,
+  0xC352,0xC35C,0xC366,0xC370,0xC37A,0xC384,0xC38E,0xC398,0xC3A2,0xC3AC,0xC3B6,0xC3C0,0xC3CA,0xC3D4,0xC3DE,0xC3E9,
+  0xC3F3,0xC3FD,0xC407,0xC410,0xC41A,0xC424,0xC42E,0xC438,0xC442,0xC44C,0xC456,0xC460,0xC46A,0xC474,0xC47E,0xC488,
+  0xC492,0xC49C,0xC4A6,0xC4B0,0xC4BA,0xC4C4,0xC4CE,0xC4D8,0xC4E2,0xC4EC,0xC4F6,0xC500,0xC50A,0xC513,0xC51D,0xC527,
+  0xC531,0xC53B,0xC545,0xC54F,0xC559,0xC563,0xC56D,0xC577,0xC580,0xC58A,0xC594,0xC59E,0xC5A8,0xC5B2,0xC5BC,0xC5C6,
+  0xC5D0,0xC5D9,0xC5E3,0xC5ED,0xC5F7,0xC601,0xC60B,0xC615,0xC61F,0xC628,0xC632,0xC63C,0xC646,0xC650,0xC65A,0xC663,
+  0xC66D,0xC677,0xC681,0xC68B,0xC695,0xC69E,0xC6A8,0xC6B2,0xC6BC,0xC6C6,0xC6D0,0xC6D9,0xC6E3,0xC6ED,0xC6F7,0xC701,
+  0xC70A,0xC714,0xC71E,0xC728,0xC732,0xC73B,0xC745,0xC74F,0xC759,0xC763,0xC76C,0xC776,0xC780,0xC78A,0xC793,0xC79D,
+  0xC7A7,0xC7B1,0xC7BA,0xC7C4,0xC7CE,0xC7D8,0xC7E1,0xC7EB,0xC7F5,0xC7FF,0xC808,0xC812,0xC81C,0xC826,0xC82F,0xC839,
+  0xC843,0xC84C,0xC856,0xC860,0xC86A,0xC873,0xC87D,0xC887,0xC890,0xC89A,0xC8A4,0xC8AE,0xC8B7,0xC8C1,0xC8CB,0xC8D4,
+  0xC8DE,0xC8E8,0xC8F1,0xC8FB,0xC905,0xC90E,0xC918,0xC922,0xC92B,0xC935,0xC93F,0xC948,0xC952,0xC95C,0xC965,0xC96F,
+  0xC979,0xC982,0xC98C,0xC995,0xC99F,0xC9A9,0xC9B2,0xC9BC,0xC9C6,0xC9CF,0xC9D9,0xC9E3,0xC9EC,0xC9F6,0xC9FF,0xCA09,
+  0xCA13,0xCA1C,0xCA26,0xCA2F,0xCA39,0xCA43,0xCA4C,0xCA56,0xCA5F,0xCA69,0xCA73,0xCA7C,0xCA86,0xCA8F,0xCA99,0xCAA2,
+  0xCAAC,0xCAB6,0xCABF,0xCAC9,0xCAD2,0xCADC,0xCAE5,0xCAEF,0xCAF8,0xCB02,0xCB0C,0xCB15,0xCB1F,0xCB28,0xCB32,0xCB3B,
+  0xCB45,0xCB4E,0xCB58,0xCB61,0xCB6B,0xCB74,0xCB7E,0xCB87,0xCB91,0xCB9B,0xCBA4,0xCBAE,0xCBB7,0xCBC1,0xCBCA,0xCBD4,
+  0xCBDD,0xCBE7,0xCBF0,0xCBFA,0xCC03,0xCC0C,0xCC16,0xCC1F,0xCC29,0xCC32,0xCC3C,0xCC45,0xCC4F,0xCC58,0xCC62,0xCC6B,
+  0xCC75,0xCC7E,0xCC88,0xCC91,0xCC9B,0xCCA4,0xCCAD,0xCCB7,0xCCC0,0xCCCA,0xCCD3,0xCCDD,0xCCE6,0xCCEF,0xCCF9,0xCD02,
+  0xCD0C,0xCD15,0xCD1F,0xCD28,0xCD31,0xCD3B,0xCD44,0xCD4E,0xCD57,0xCD61,0xCD6A,0xCD73,0xCD7D,0xCD86,0xCD90,0xCD99,
+  0xCDA2,0xCDAC,0xCDB5,0xCDBE,0xCDC8,0xCDD1,0xCDDB,0xCDE4,0xCDED,0xCDF7,0xCE00,0xCE09,0xCE13,0xCE1C,0xCE26,0xCE2F,
+  0xCE38,0xCE42,0xCE4B,0xCE54,0xCE5E,0xCE67,0xCE70,0xCE7A,0xCE83,0xCE8C,0xCE96,0xCE9F,0xCEA8,0xCEB2,0xCEBB,0xCEC4,
+  0xCECE,0xCED7,0xCEE0,0xCEEA,0xCEF3,0xCEFC,0xCF06,0xCF0F,0xCF18,0xCF21,0xCF2B,0xCF34,0xCF3D,0xCF47,0xCF50,0xCF59,
+  0xCF62,0xCF6C,0xCF75,0xCF7E,0xCF88,0xCF91,0xCF9A,0xCFA3,0xCFAD,0xCFB6,0xCFBF,0xCFC8,0xCFD2,0xCFDB,0xCFE4,0xCFEE,
+  0xCFF7,0xD000,0xD009,0xD013,0xD01C,0xD025,0xD02E,0xD037,0xD041,0xD04A,0xD053,0xD05C,0xD066,0xD06F,0xD078,0xD081,
+  0xD08B,0xD094,0xD09D,0xD0A6,0xD0AF,0xD0B9,0xD0C2,0xD0CB,0xD0D4,0xD0DD,0xD0E7,0xD0F0,0xD0F9,0xD102,0xD10B,0xD115,
+  0xD11E,0xD127,0xD130,0xD139,0xD142,0xD14C,0xD155,0xD15E,0xD167,0xD170,0xD17A,0xD183,0xD18C,0xD195,0xD19E,0xD1A7,
+  0xD1B0,0xD1BA,0xD1C3,0xD1CC,0xD1D5,0xD1DE,0xD1E7,0xD1F0,0xD1FA,0xD203,0xD20C,0xD215,0xD21E,0xD227,0xD230,0xD23A,
+  0xD243,0xD24C,0xD255,0xD25E,0xD267,0xD270,0xD279,0xD282,0xD28C,0xD295,0xD29E,0xD2A7,0xD2B0,0xD2B9,0xD2C2,0xD2CB,
+  0xD2D4,0xD2DD,0xD2E6,0xD2F0,0xD2F9,0xD302,0xD30B,0xD314,0xD31D,0xD326,0xD32F,0xD338,0xD341,0xD34A,0xD353,0xD35C,
+  0xD365,0xD36E,0xD378,0xD381,0xD38A,0xD393,0xD39C,0xD3A5,0xD3AE,0xD3B7,0xD3C0,0xD3C9,0xD3D2,0xD3DB,0xD3E4,0xD3ED,
+  0xD3F6,0xD3FF,0xD408,0xD411,0xD41A,0xD423,0xD42C,0xD435,0xD43E,0xD447,0xD450,0xD459,0xD462,0xD46B,0xD474,0xD47D,
+  0xD486,0xD48F,0xD498,0xD4A1,0xD4AA,0xD4B3,0xD4BC,0xD4C5,0xD4CE,0xD4D7,0xD4E0,0xD4E9,0xD4F2,0xD4FB,0xD504,0xD50D,
+  0xD516,0xD51F,0xD528,0xD531,0xD53A,0xD543,0xD54C,0xD554,0xD55D,0xD566,0xD56F,0xD578,0xD581,0xD58A,0xD593,0xD59C,
+  0xD5A5,0xD5AE,0xD5B7,0xD5C0,0xD5C9,0xD5D2,0xD5DA,0xD5E3,0xD5EC,0xD5F5,0xD5FE,0xD607,0xD610,0xD619,0xD622,0xD62B,
+  0xD634,0xD63C,0xD645,0xD64E,0xD657,0xD660,0xD669,0xD672,0xD67B,0xD684,0xD68C,0xD695,0xD69E,0xD6A7,0xD6B0,0xD6B9,
+  0xD6C2,0xD6CB,0xD6D3,0xD6DC,0xD6E5,0xD6EE,0xD6F7,0xD700,0xD709,0xD711,0xD71A,0xD723,0xD72C,0xD735,0xD73E,0xD747,
+  0xD74F,0xD758,0xD761,0xD76A,0xD773,0xD77C,0xD784,0xD78D,0xD796,0xD79F,0xD7A8,0xD7B1,0xD7B9,0xD7C2,0xD7CB,0xD7D4,
+  0xD7DD,0xD7E5,0xD7EE,0xD7F7,0xD800,0xD809,0xD811,0xD81A,0xD823,0xD82C,0xD835,0xD83D,0xD846,0xD84F,0xD858,0xD861,
+  0xD869,0xD872,0xD87B,0xD884,0xD88C,0xD895,0xD89E,0xD8A7,0xD8B0,0xD8B8,0xD8C1,0xD8CA,0xD8D3,0xD8DB,0xD8E4,0xD8ED,
+  0xD8F6,0xD8FE,0xD907,0xD910,0xD919,0xD921,0xD92A,0xD933,0xD93C,0xD944,0xD94D,0xD956,0xD95E,0xD967,0xD970,0xD979,
+  0xD981,0xD98A,0xD993,0xD99C,0xD9A4,0xD9AD,0xD9B6,0xD9BE,0xD9C7,0xD9D0,0xD9D9,0xD9E1,0xD9EA,0xD9F3,0xD9FB,0xDA04,
+  0xDA0D,0xDA15,0xDA1E,0xDA27,0xDA2F,0xDA38,0xDA41,0xDA4A,0xDA52,0xDA5B,0xDA64,0xDA6C,0xDA75,0xDA7E,0xDA86,0xDA8F,
+  0xDA98,0xDAA0,0xDAA9,0xDAB2,0xDABA,0xDAC3,0xDACC,0xDAD4,0xDADD,0xDAE6,0xDAEE,0xDAF7,0xDAFF,0xDB08,0xDB11,0xDB19,
+  0xDB22,0xDB2B,0xDB33,0xDB3C,0xDB45,0xDB4D,0xDB56,0xDB5E,0xDB67,0xDB70,0xDB78,0xDB81,0xDB8A,0xDB92,0xDB9B,0xDBA3,
+  0xDBAC,0xDBB5,0xDBBD,0xDBC6,0xDBCE,0xDBD7,0xDBE0,0xDBE8,0xDBF1,0xDBF9,0xDC02,0xDC0B,0xDC13,0xDC1C,0xDC24,0xDC2D,
+  0xDC36,0xDC3E,0xDC47,0xDC4F,0xDC58,0xDC60,0xDC69,0xDC72,0xDC7A,0xDC83,0xDC8B,0xDC94,0xDC9C,0xDCA5,0xDCAE,0xDCB6,
+  0xDCBF,0xDCC7,0xDCD0,0xDCD8,0xDCE1,0xDCE9,0xDCF2,0xDCFA,0xDD03,0xDD0C,0xDD14,0xDD1D,0xDD25,0xDD2E,0xDD36,0xDD3F,
+  0xDD47,0xDD50,0xDD58,0xDD61,0xDD69,0xDD72,0xDD7A,0xDD83,0xDD8B,0xDD94,0xDD9C,0xDDA5,0xDDAD,0xDDB6,0xDDBE,0xDDC7,
+  0xDDCF,0xDDD8,0xDDE0,0xDDE9,0xDDF1,0xDDFA,0xDE02,0xDE0B,0xDE13,0xDE1C,0xDE24,0xDE2D,0xDE35,0xDE3E,0xDE46,0xDE4F,
+  0xDE57,0xDE60,0xDE68,0xDE71,0xDE79,0xDE82,0xDE8A,0xDE93,0xDE9B,0xDEA3,0xDEAC,0xDEB4,0xDEBD,0xDEC5,0xDECE,0xDED6,
+  0xDEDF,0xDEE7,0xDEF0,0xDEF8,0xDF00,0xDF09,0xDF11,0xDF1A,0xDF22,0xDF2B,0xDF33,0xDF3B,0xDF44,0xDF4C,0xDF55,0xDF5D,
+  0xDF66,0xDF6E,0xDF76,0xDF7F,0xDF87,0xDF90,0xDF98,0xDFA1,0xDFA9,0xDFB1,0xDFBA,0xDFC2,0xDFCB,0xDFD3,0xDFDB,0xDFE4,
+  0xDFEC,0xDFF5,0xDFFD,0xE005,0xE00E,0xE016,0xE01E,0xE027,0xE02F,0xE038,0xE040,0xE048,0xE051,0xE059,0xE062,0xE06A,
+  0xE072,0xE07B,0xE083,0xE08B,0xE094,0xE09C,0xE0A4,0xE0AD,0xE0B5,0xE0BE,0xE0C6,0xE0CE,0xE0D7,0xE0DF,0xE0E7,0xE0F0,
+  0xE0F8,0xE100,0xE109,0xE111,0xE119,0xE122,0xE12A,0xE132,0xE13B,0xE143,0xE14B,0xE154,0xE15C,0xE164,0xE16D,0xE175,
+  0xE17D,0xE186,0xE18E,0xE196,0xE19F,0xE1A7,0xE1AF,0xE1B7,0xE1C0,0xE1C8,0xE1D0,0xE1D9,0xE1E1,0xE1E9,0xE1F2,0xE1FA,
+  0xE202,0xE20A,0xE213,0xE21B,0xE223,0xE22C,0xE234,0xE23C,0xE244,0xE24D,0xE255,0xE25D,0xE266,0xE26E,0xE276,0xE27E,
+  0xE287,0xE28F,0xE297,0xE29F,0xE2A8,0xE2B0,0xE2B8,0xE2C0,0xE2C9,0xE2D1,0xE2D9,0xE2E1,0xE2EA,0xE2F2,0xE2FA,0xE302,
+  0xE30B,0xE313,0xE31B,0xE323,0xE32C,0xE334,0xE33C,0xE344,0xE34D,0xE355,0xE35D,0xE365,0xE36E,0xE376,0xE37E,0xE386,
+  0xE38E,0xE397,0xE39F,0xE3A7,0xE3AF,0xE3B8,0xE3C0,0xE3C8,0xE3D0,0xE3D8,0xE3E1,0xE3E9,0xE3F1,0xE3F9,0xE401,0xE40A,
+  0xE412,0xE41A,0xE422,0xE42A,0xE433,0xE43B,0xE443,0xE44B,0xE453,0xE45B,0xE464,0xE46C,0xE474,0xE47C,0xE484,0xE48C,
+  0xE495,0xE49D,0xE4A5,0xE4AD,0xE4B5,0xE4BD,0xE4C6,0xE4CE,0xE4D6,0xE4DE,0xE4E6,0xE4EE,0xE4F7,0xE4FF,0xE507,0xE50F,
+  0xE517,0xE51F,0xE527,0xE530,0xE538,0xE540,0xE548,0xE550,0xE558,0xE560,0xE569,0xE571,0xE579,0xE581,0xE589,0xE591,
+  0xE599,0xE5A1,0xE5AA,0xE5B2,0xE5BA,0xE5C2,0xE5CA,0xE5D2,0xE5DA,0xE5E2,0xE5EA,0xE5F3,0xE5FB,0xE603,0xE60B,0xE613,
+  0xE61B,0xE623,0xE62B,0xE633,0xE63C,0xE644,0xE64C,0xE654,0xE65C,0xE664,0xE66C,0xE674,0xE67C,0xE684,0xE68C,0xE694,
+  0xE69D,0xE6A5,0xE6AD,0xE6B5,0xE6BD,0xE6C5,0xE6CD,0xE6D5,0xE6DD,0xE6E5,0xE6ED,0xE6F5,0xE6FD,0xE705,0xE70D,0xE715,
+  0xE71E,0xE726,0xE72E,0xE736,0xE73E,0xE746,0xE74E,0xE756,0xE75E,0xE766,0xE76E,0xE776,0xE77E,0xE786,0xE78E,0xE796,
+  0xE79E,0xE7A6,0xE7AE,0xE7B6,0xE7BE,0xE7C6,0xE7CE,0xE7D6,0xE7DE,0xE7E6,0xE7EE,0xE7F6,0xE7FE,0xE806,0xE80E,0xE816,
+  0xE81E,0xE826,0xE82E,0xE836,0xE83E,0xE846,0xE84E,0xE856,0xE85E,0xE866,0xE86E,0xE876,0xE87E,0xE886,0xE88E,0xE896,
+  0xE89E,0xE8A6,0xE8AE,0xE8B6,0xE8BE,0xE8C6,0xE8CE,0xE8D6,0xE8DE,0xE8E6,0xE8EE,0xE8F6,0xE8FE,0xE906,0xE90E,0xE916,
+  0xE91E,0xE926,0xE92E,0xE936,0xE93E,0xE946,0xE94E,0xE956,0xE95E,0xE966,0xE96E,0xE975,0xE97D,0xE985,0xE98D,0xE995,
+  0xE99D,0xE9A5,0xE9AD,0xE9B5,0xE9BD,0xE9C5,0xE9CD,0xE9D5,0xE9DD,0xE9E5,0xE9EC,0xE9F4,0xE9FC,0xEA04,0xEA0C,0xEA14,
+  0xEA1C,0xEA24,0xEA2C,0xEA34,0xEA3C,0xEA44,0xEA4B,0xEA53,0xEA5B,0xEA63,0xEA6B,0xEA73,0xEA7B,0xEA83,0xEA8B,0xEA93,
+  0xEA9A,0xEAA2,0xEAAA,0xEAB2,0xEABA,0xEAC2,0xEACA,0xEAD2,0xEADA,0xEAE1,0xEAE9,0xEAF1,0xEAF9,0xEB01,0xEB09,0xEB11,
+  0xEB19,0xEB21,0xEB28,0xEB30,0xEB38,0xEB40,0xEB48,0xEB50,0xEB58,0xEB5F,0xEB67,0xEB6F,0xEB77,0xEB7F,0xEB87,0xEB8F,
+  0xEB96,0xEB9E,0xEBA6,0xEBAE,0xEBB6,0xEBBE,0xEBC6,0xEBCD,0xEBD5,0xEBDD,0xEBE5,0xEBED,0xEBF5,0xEBFC,0xEC04,0xEC0C,
+  0xEC14,0xEC1C,0xEC24,0xEC2B,0xEC33,0xEC3B,0xEC43,0xEC4B,0xEC52,0xEC5A,0xEC62,0xEC6A,0xEC72,0xEC7A,0xEC81,0xEC89,
+  0xEC91,0xEC99,0xECA1,0xECA8,0xECB0,0xECB8,0xECC0,0xECC8,0xECCF,0xECD7,0xECDF,0xECE7,0xECEF,0xECF6,0xECFE,0xED06,
+  0xED0E,0xED16,0xED1D,0xED25,0xED2D,0xED35,0xED3C,0xED44,0xED4C,0xED54,0xED5C,0xED63,0xED6B,0xED73,0xED7B,0xED82,
+  0xED8A,0xED92,0xED9A,0xEDA1,0xEDA9,0xEDB1,0xEDB9,0xEDC0,0xEDC8,0xEDD0,0xEDD8,0xEDE0,0xEDE7,0xEDEF,0xEDF7,0xEDFF,
+  0xEE06,0xEE0E,0xEE16,0xEE1D,0xEE25,0xEE2D,0xEE35,0xEE3C,0xEE44,0xEE4C,0xEE54,0xEE5B,0xEE63,0xEE6B,0xEE73,0xEE7A,
+  0xEE82,0xEE8A,0xEE91,0xEE99,0xEEA1,0xEEA9,0xEEB0,0xEEB8,0xEEC0,0xEEC7,0xEECF,0xEED7,0xEEDF,0xEEE6,0xEEEE,0xEEF6,
+  0xEEFD,0xEF05,0xEF0D,0xEF15,0xEF1C,0xEF24,0xEF2C,0xEF33,0xEF3B,0xEF43,0xEF4A,0xEF52,0xEF5A,0xEF61,0xEF69,0xEF71,
+  0xEF79,0xEF80,0xEF88,0xEF90,0xEF97,0xEF9F,0xEFA7,0xEFAE,0xEFB6,0xEFBE,0xEFC5,0xEFCD,0xEFD5,0xEFDC,0xEFE4,0xEFEC,
+  0xEFF3,0xEFFB,0xF003,0xF00A,0xF012,0xF01A,0xF021,0xF029,0xF031,0xF038,0xF040,0xF048,0xF04F,0xF057,0xF05E,0xF066,
+  0xF06E,0xF075,0xF07D,0xF085,0xF08C,0xF094,0xF09C,0xF0A3,0xF0AB,0xF0B2,0xF0BA,0xF0C2,0xF0C9,0xF0D1,0xF0D9,0xF0E0,
+  0xF0E8,0xF0F0,0xF0F7,0xF0FF,0xF106,0xF10E,0xF116,0xF11D,0xF125,0xF12C,0xF134,0xF13C,0xF143,0xF14B,0xF152,0xF15A,
+  0xF162,0xF169,0xF171,0xF178,0xF180,0xF188,0xF18F,0xF197,0xF19E,0xF1A6,0xF1AE,0xF1B5,0xF1BD,0xF1C4,0xF1CC,0xF1D4,
+  0xF1DB,0xF1E3,0xF1EA,0xF1F2,0xF1FA,0xF201,0xF209,0xF210,0xF218,0xF21F,0xF227,0xF22F,0xF236,0xF23E,0xF245,0xF24D,
+  0xF254,0xF25C,0xF263,0xF26B,0xF273,0xF27A,0xF282,0xF289,0xF291,0xF298,0xF2A0,0xF2A7,0xF2AF,0xF2B7,0xF2BE,0xF2C6,
+  0xF2CD,0xF2D5,0xF2DC,0xF2E4,0xF2EB,0xF2F3,0xF2FA,0xF302,0xF30A,0xF311,0xF319,0xF320,0xF328,0xF32F,0xF337,0xF33E,
+  0xF346,0xF34D,0xF355,0xF35C,0xF364,0xF36B,0xF373,0xF37A,0xF382,0xF389,0xF391,0xF398,0xF3A0,0xF3A7,0xF3AF,0xF3B7,
+  0xF3BE,0xF3C6,0xF3CD,0xF3D5,0xF3DC,0xF3E4,0xF3EB,0xF3F3,0xF3FA,0xF402,0xF409,0xF411,0xF418,0xF41F,0xF427,0xF42E,
+  0xF436,0xF43D,0xF445,0xF44C,0xF454,0xF45B,0xF463,0xF46A,0xF472,0xF479,0xF481,0xF488,0xF490,0xF497,0xF49F,0xF4A6,
+  0xF4AE,0xF4B5,0xF4BD,0xF4C4,0xF4CB,0xF4D3,0xF4DA,0xF4E2,0xF4E9,0xF4F1,0xF4F8,0xF500,0xF507,0xF50F,0xF516,0xF51D,
+  0xF525,0xF52C,0xF534,0xF53B,0xF543,0xF54A,0xF552,0xF559,0xF560,0xF568,0xF56F,0xF577,0xF57E,0xF586,0xF58D,0xF595,
+  0xF59C,0xF5A3,0xF5AB,0xF5B2,0xF5BA,0xF5C1,0xF5C9,0xF5D0,0xF5D7,0xF5DF,0xF5E6,0xF5EE,0xF5F5,0xF5FC,0xF604,0xF60B,
+  0xF613,0xF61A,0xF622,0xF629,0xF630,0xF638,0xF63F,0xF647,0xF64E,0xF655,0xF65D,0xF664,0xF66C,0xF673,0xF67A,0xF682,
+  0xF689,0xF691,0xF698,0xF69F,0xF6A7,0xF6AE,0xF6B5,0xF6BD,0xF6C4,0xF6CC,0xF6D3,0xF6DA,0xF6E2,0xF6E9,0xF6F1,0xF6F8,
+  0xF6FF,0xF707,0xF70E,0xF715,0xF71D,0xF724,0xF72C,0xF733,0xF73A,0xF742,0xF749,0xF750,0xF758,0xF75F,0xF766,0xF76E,
+  0xF775,0xF77C,0xF784,0xF78B,0xF793,0xF79A,0xF7A1,0xF7A9,0xF7B0,0xF7B7,0xF7BF,0xF7C6,0xF7CD,0xF7D5,0xF7DC,0xF7E3,
+  0xF7EB,0xF7F2,0xF7F9,0xF801,0xF808,0xF80F,0xF817,0xF81E,0xF825,0xF82D,0xF834,0xF83B,0xF843,0xF84A,0xF851,0xF859,
+  0xF860,0xF867,0xF86F,0xF876,0xF87D,0xF885,0xF88C,0xF893,0xF89B,0xF8A2,0xF8A9,0xF8B0,0xF8B8,0xF8BF,0xF8C6,0xF8CE,
+  0xF8D5,0xF8DC,0xF8E4,0xF8EB,0xF8F2,0xF8F9,0xF901,0xF908,0xF90F,0xF917,0xF91E,0xF925,0xF92D,0xF934,0xF93B,0xF942,
+  0xF94A,0xF951,0xF958,0xF960,0xF967,0xF96E,0xF975,0xF97D,0xF984,0xF98B,0xF992,0xF99A,0xF9A1,0xF9A8,0xF9B0,0xF9B7,
+  0xF9BE,0xF9C5,0xF9CD,0xF9D4,0xF9DB,0xF9E2,0xF9EA,0xF9F1,0xF9F8,0xF9FF,0xFA07,0xFA0E,0xFA15,0xFA1C,0xFA24,0xFA2B,
+  0xFA32,0xFA3A,0xFA41,0xFA48,0xFA4F,0xFA56,0xFA5E,0xFA65,0xFA6C,0xFA73,0xFA7B,0xFA82,0xFA89,0xFA90,0xFA98,0xFA9F,
+  0xFAA6,0xFAAD,0xFAB5,0xFABC,0xFAC3,0xFACA,0xFAD1,0xFAD9,0xFAE0,0xFAE7,0xFAEE,0xFAF6,0xFAFD,0xFB04,0xFB0B,0xFB12,
+  0xFB1A,0xFB21,0xFB28,0xFB2F,0xFB37,0xFB3E,0xFB45,0xFB4C,0xFB53,0xFB5B,0xFB62,0xFB69,0xFB70,0xFB77,0xFB7F,0xFB86,
+  0xFB8D,0xFB94,0xFB9B,0xFBA3,0xFBAA,0xFBB1,0xFBB8,0xFBBF,0xFBC7,0xFBCE,0xFBD5,0xFBDC,0xFBE3,0xFBEB,0xFBF2,0xFBF9,
+  0xFC00,0xFC07,0xFC0E,0xFC16,0xFC1D,0xFC24,0xFC2B,0xFC32,0xFC39,0xFC41,0xFC48,0xFC4F,0xFC56,0xFC5D,0xFC65,0xFC6C,
+  0xFC73,0xFC7A,0xFC81,0xFC88,0xFC8F,0xFC97,0xFC9E,0xFCA5,0xFCAC,0xFCB3,0xFCBA,0xFCC2,0xFCC9,0xFCD0,0xFCD7,0xFCDE,
+  0xFCE5,0xFCEC,0xFCF4,0xFCFB,0xFD02,0xFD09,0xFD10,0xFD17,0xFD1E,0xFD26,0xFD2D,0xFD34,0xFD3B,0xFD42,0xFD49,0xFD50,
+  0xFD58,0xFD5F,0xFD66,0xFD6D,0xFD74,0xFD7B,0xFD82,0xFD89,0xFD91,0xFD98,0xFD9F,0xFDA6,0xFDAD,0xFDB4,0xFDBB,0xFDC2,
+  0xFDCA,0xFDD1,0xFDD8,0xFDDF,0xFDE6,0xFDED,0xFDF4,0xFDFB,0xFE02,0xFE0A,0xFE11,0xFE18,0xFE1F,0xFE26,0xFE2D,0xFE34,
+  0xFE3B,0xFE42,0xFE49,0xFE51,0xFE58,0xFE5F,0xFE66,0xFE6D,0xFE74,0xFE7B,0xFE82,0xFE89,0xFE90,0xFE97,0xFE9F,0xFEA6,
+  0xFEAD,0xFEB4,0xFEBB,0xFEC2,0xFEC9,0xFED0,0xFED7,0xFEDE,0xFEE5,0xFEEC,0xFEF3,0xFEFB,0xFF02,0xFF09,0xFF10,0xFF17,
+  0xFF1E,0xFF25,0xFF2C,0xFF33,0xFF3A,0xFF41,0xFF48,0xFF4F,0xFF56,0xFF5D,0xFF64,0xFF6C,0xFF73,0xFF7A,0xFF81,0xFF88,
+  0xFF8F,0xFF96,0xFF9D,0xFFA4,0xFFAB,0xFFB2,0xFFB9,0xFFC0,0xFFC7,0xFFCE,0xFFD5,0xFFDC,0xFFE3,0xFFEA,0xFFF1,0xFFF8,
+  0xFFFF
+  };
@@ -5,6 +5,8 @@ extern const uint16_t gammaLUT8to16[];
 
 extern const uint8_t invGammaLUT12to8[];
 
+extern const uint16_t invGammaLUT12to16[];
+
 inline uint8_t encodeGamma16to8(uint16_t c) {
     return invGammaLUT12to8[c>>4];
 }
@@ -13,4 +15,19 @@ inline uint16_t decodeGamma8to16(uint8_t c) {
     return gammaLUT8to16[c];
 }
 
+inline uint16_t encodeGamma16to16(uint16_t c) {
+    uint32_t x = c * 4096u + c * 4096u / 65535u; // position in the 12bit table, 16 fractional bits, 0xFFFF on the last entry
+    uint16_t lo = invGammaLUT12to16[x>>16];
+    if ((x & 0xFFFF) == 0) return lo;
+    uint16_t hi = invGammaLUT12to16[(x>>16)+1];
+    return lo + (((hi - lo) * (x & 0xFFFF)) >> 16);
+}
+
+inline uint16_t decodeGamma16to16(uint16_t c) {
+    uint32_t x = c * 255u; // position in the 8bit table, 16 fractional bits
+    uint16_t lo = gammaLUT8to16[x>>16];
+    uint16_t hi = gammaLUT8to16[(x>>16)+1];
+    return lo + (((hi - lo) * (x & 0xFFFF)) >> 16);
+}
+
 #endif